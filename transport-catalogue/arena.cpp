@@ -0,0 +1,74 @@
+#include "arena.h"
+
+#include <algorithm>
+
+namespace catalogue {
+
+Arena::Block::Block(size_t size)
+    : data(new char[size])
+    , size(size) {
+}
+
+// Потоки резервируют участки блока сравнением с обменом, так что участки не пересекаются
+void* Arena::Block::TryAllocate(size_t size, size_t alignment) {
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data.get());
+    size_t offset = used.load(std::memory_order_relaxed);
+    while (true) {
+        const uintptr_t result = (begin + offset + alignment - 1) & ~(uintptr_t{alignment} - 1);
+        const size_t end = result - begin + size;
+        if (end > this->size) {
+            return nullptr;
+        }
+        if (used.compare_exchange_weak(offset, end, std::memory_order_relaxed)) {
+            return reinterpret_cast<void*>(result);
+        }
+    }
+}
+
+// Крупные выделения получают собственный блок, чтобы не выбрасывать остаток текущего
+void* Arena::Allocate(size_t size, size_t alignment) {
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes_.fetch_add(size, std::memory_order_relaxed);
+    if (size > MAX_BLOCK_SIZE / 4) {
+        std::lock_guard guard(mutex_);
+        return AddBlock(size + alignment).TryAllocate(size, alignment);
+    }
+    while (true) {
+        Block* block = current_.load(std::memory_order_acquire);
+        if (block != nullptr) {
+            if (void* result = block->TryAllocate(size, alignment)) {
+                return result;
+            }
+        }
+        ReplaceFullBlock(block, size + alignment);
+    }
+}
+
+ArenaStats Arena::GetStats() const {
+    std::lock_guard guard(mutex_);
+    return {allocations_.load(std::memory_order_relaxed),
+            allocated_bytes_.load(std::memory_order_relaxed),
+            freed_bytes_.load(std::memory_order_relaxed),
+            reserved_bytes_,
+            blocks_.size()};
+}
+
+Arena::Block& Arena::AddBlock(size_t size) {
+    blocks_.push_back(std::make_unique<Block>(size));
+    reserved_bytes_ += size;
+    return *blocks_.back();
+}
+
+// Размер блоков удваивается, поэтому число блоков растёт логарифмически
+void Arena::ReplaceFullBlock(Block* full, size_t min_size) {
+    std::lock_guard guard(mutex_);
+    if (current_.load(std::memory_order_relaxed) != full) {
+        // Блок уже заменил другой поток
+        return;
+    }
+    Block& block = AddBlock(std::max(next_block_size_, min_size));
+    next_block_size_ = std::min(next_block_size_ * 2, MAX_BLOCK_SIZE);
+    current_.store(&block, std::memory_order_release);
+}
+
+}  // namespace catalogue
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace catalogue {
+
+struct ArenaStats {
+    size_t allocations = 0;         // число выделений
+    size_t allocated_bytes = 0;     // запрошено байт
+    size_t freed_bytes = 0;         // из них освобождено, но не возвращено в блоки
+    size_t reserved_bytes = 0;      // занято блоками
+    size_t blocks = 0;
+};
+
+// Монотонная арена: память выдаётся из крупных блоков сдвигом указателя, отдельные выделения
+// только учитываются как освобождённые, а все блоки освобождаются разом вместе с ареной.
+// Allocate() и Deallocate() можно вызывать из нескольких потоков одновременно
+class Arena {
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment);
+    void Deallocate(size_t size) {
+        freed_bytes_.fetch_add(size, std::memory_order_relaxed);
+    }
+    ArenaStats GetStats() const;
+
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = 16 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+    struct Block {
+        explicit Block(size_t size);
+        // nullptr, если в блоке не хватает места
+        void* TryAllocate(size_t size, size_t alignment);
+
+        std::unique_ptr<char[]> data;
+        size_t size;
+        std::atomic<size_t> used{0};
+    };
+
+    // Блок, из которого сейчас выделяется память; меняется под mutex_
+    std::atomic<Block*> current_{nullptr};
+    std::atomic<size_t> allocations_{0};
+    std::atomic<size_t> allocated_bytes_{0};
+    std::atomic<size_t> freed_bytes_{0};
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Block>> blocks_;
+    size_t next_block_size_ = MIN_BLOCK_SIZE;
+    size_t reserved_bytes_ = 0;
+
+    Block& AddBlock(size_t size);
+    void ReplaceFullBlock(Block* full, size_t min_size);
+};
+
+// Аллокатор контейнеров справочника. Контейнер держит арену живой, пока сам не разрушен.
+// Без арены (по умолчанию) память берётся из кучи. Копия контейнера получает аллокатор
+// без арены, чтобы копии, сделанные вне справочника, не росли в его арене
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept = default;
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena) noexcept
+        : arena_(std::move(arena)) {
+    }
+    // Перемещение копирует: контейнер может пользоваться аллокатором и после перемещения
+    ArenaAllocator(const ArenaAllocator&) noexcept = default;
+    ArenaAllocator& operator=(const ArenaAllocator&) noexcept = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(other.arena_) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (arena_ == nullptr) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        if (arena_ == nullptr) {
+            ::operator delete(p);
+        } else {
+            arena_->Deallocate(n * sizeof(T));
+        }
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const noexcept {
+        return {};
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ != other.arena_;
+    }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    std::shared_ptr<Arena> arena_;
+};
+
+}  // namespace catalogue
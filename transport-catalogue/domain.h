@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "arena.h"
 #include "geo.h"
 
 /*
@@ -21,15 +25,105 @@ namespace catalogue {
 
 // Определение структуры остановки
 struct Stop {
-    std::string name;
-    geo::Coordinates coord;
+    std::string_view name;      // строка в StringInterner справочника
+    geo::StoredCoordinates coord;
+    uint32_t id = 0;    // порядковый номер остановки в справочнике
+};
+
+// Остановки маршрута; у маршрутов справочника лежат в его арене
+using StopSequence = std::vector<const Stop*, ArenaAllocator<const Stop*>>;
+
+// Полная последовательность остановок маршрута. Для некольцевого маршрута [A,B,C]
+// обратный путь получается отражением: [A,B,C,B,A], без хранения копии.
+// Представление ссылается на остановки маршрута и действительно, пока жив Bus
+class RouteStops {
+public:
+    // Элементы отражённой части вычисляются на лету, поэтому operator* возвращает значение,
+    // а не ссылку, и итератор подходит только для однопроходных алгоритмов
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = const Stop*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        Iterator(const RouteStops& route, size_t index)
+            : route_(&route), index_(index) {
+        }
+        reference operator*() const {
+            return (*route_)[index_];
+        }
+        Iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator prev = *this;
+            ++index_;
+            return prev;
+        }
+        bool operator==(const Iterator& other) const {
+            return index_ == other.index_;
+        }
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+    private:
+        const RouteStops* route_;
+        size_t index_;
+    };
+
+    RouteStops(const StopSequence& stops, bool is_roundtrip)
+        : stops_(stops), is_roundtrip_(is_roundtrip) {
+    }
+    RouteStops(StopSequence&& stops, bool is_roundtrip) = delete;
+
+    size_t size() const {
+        if (is_roundtrip_ || stops_.empty()) {
+            return stops_.size();
+        }
+        return stops_.size() * 2 - 1;
+    }
+    bool empty() const {
+        return stops_.empty();
+    }
+    const Stop* operator[](size_t index) const {
+        return index < stops_.size() ? stops_[index] : stops_[size() - 1 - index];
+    }
+    const Stop* front() const {
+        return stops_.front();
+    }
+    // Конечная остановка совпадает с начальной и для кольцевого, и для некольцевого маршрута
+    const Stop* back() const {
+        return is_roundtrip_ ? stops_.back() : stops_.front();
+    }
+    Iterator begin() const {
+        return {*this, 0};
+    }
+    Iterator end() const {
+        return {*this, size()};
+    }
+
+private:
+    const StopSequence& stops_;
+    bool is_roundtrip_;
 };
 
 // Определение структуры автобуса
 struct Bus {
-    std::string name;
+    // Строка в StringInterner справочника; AddBus заменяет её на интернированную
+    std::string_view name;
     bool is_roundtrip = false;
-    std::vector<const Stop*> stops;
+    // Для кольцевого маршрута [A,B,C,A], для некольцевого только прямой путь [A,B,C,D]
+    StopSequence stops;
+    uint32_t id = 0;    // порядковый номер маршрута в справочнике
+
+    RouteStops GetRoute() const & {
+        return {stops, is_roundtrip};
+    }
+    // Представление временного маршрута сразу бы повисло
+    RouteStops GetRoute() const && = delete;
 };
 
 } // namespace catalogue
\ No newline at end of file
@@ -1,9 +1,27 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
-namespace Catalogue {
+#include <algorithm>
+
 namespace geo {
 
+void ComputeDistances(const PreparedCoordinatesArray& from, const PreparedCoordinatesArray& to, double* result){
+    const size_t count = std::min(from.Size(), to.Size());
+    const double* from_sin = from.sin_lat.data();
+    const double* from_cos = from.cos_lat.data();
+    const double* from_lng = from.lng.data();
+    const double* to_sin = to.sin_lat.data();
+    const double* to_cos = to.cos_lat.data();
+    const double* to_lng = to.lng.data();
+
+    for (size_t i = 0; i < count; ++i) {
+        const bool same_point = from_sin[i] == to_sin[i] && from_cos[i] == to_cos[i] && from_lng[i] == to_lng[i];
+        double cos_angle = from_sin[i] * to_sin[i]
+                         + from_cos[i] * to_cos[i] * std::cos(std::abs(from_lng[i] - to_lng[i]));
+        // совпадающие точки дают ровно 0, а погрешность округления не выводит за область acos
+        cos_angle = same_point ? 1. : std::min(cos_angle, 1.);
+        result[i] = std::acos(cos_angle) * EARTH_RADIUS;
+    }
+}
 
 }  // namespace geo
-} // namespace Catalogue
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <cmath>
+#include <vector>
 
 // namespace Catalogue {
 namespace geo {
 
+inline const double DEG_TO_RAD = 3.1415926535 / 180.;
+inline const int EARTH_RADIUS = 6371000;
+
 struct Coordinates {
     double lat;
     double lng;
@@ -17,9 +23,53 @@ struct Coordinates {
     }
 };
 
+// Координаты в целых микроградусах: вдвое компактнее Coordinates,
+// сравнение точное. Точность - около 0.1 м
+struct FixedCoordinates {
+    int32_t lat;
+    int32_t lng;
+    bool operator==(const FixedCoordinates& other) const {
+        return lat == other.lat && lng == other.lng;
+    }
+    bool operator!=(const FixedCoordinates& other) const {
+        return !(*this == other);
+    }
+};
+
+inline const double FIXED_COORDINATES_SCALE = 1e6;
+
+inline FixedCoordinates ToFixedCoordinates(Coordinates coord){
+    return {static_cast<int32_t>(std::lround(coord.lat * FIXED_COORDINATES_SCALE)),
+            static_cast<int32_t>(std::lround(coord.lng * FIXED_COORDINATES_SCALE))};
+}
+
+// Переход к вещественным координатам на границе вычислений
+inline Coordinates ToCoordinates(FixedCoordinates coord){
+    return {coord.lat / FIXED_COORDINATES_SCALE, coord.lng / FIXED_COORDINATES_SCALE};
+}
+inline Coordinates ToCoordinates(Coordinates coord){
+    return coord;
+}
+
+// Представление координат, в котором справочник хранит остановки.
+// Сборка с GEO_FIXED_POINT_COORDINATES включает целочисленное хранение: Stop занимает 32 байта
+// вместо 40. Подготовленная тригонометрия остановок (3 double) хранится в обоих режимах,
+// поэтому экономия - 8 байт из 64 на остановку
+#ifdef GEO_FIXED_POINT_COORDINATES
+using StoredCoordinates = FixedCoordinates;
+inline StoredCoordinates ToStoredCoordinates(Coordinates coord){
+    return ToFixedCoordinates(coord);
+}
+#else
+using StoredCoordinates = Coordinates;
+inline StoredCoordinates ToStoredCoordinates(Coordinates coord){
+    return coord;
+}
+#endif
+
 struct Distance{
     unsigned int dist;
-    std::string name_location;
+    std::string_view name_location;
 };
 
 inline double ComputeDistance(Coordinates from, Coordinates to){
@@ -27,12 +77,62 @@ inline double ComputeDistance(Coordinates from, Coordinates to){
     if (from == to) {
         return 0;
     }
-    static const double dr = 3.1415926535 / 180.;
-    static const int earth_radius = 6371000;
+    static const double dr = DEG_TO_RAD;
+    static const int earth_radius = EARTH_RADIUS;
     return acos(sin(from.lat * dr) * sin(to.lat * dr)
                 + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
         * earth_radius;
 }
 
+// Координаты точки с заранее посчитанной тригонометрией широты.
+// Широта точки не меняется, поэтому sin/cos достаточно вычислить один раз
+struct PreparedCoordinates {
+    double sin_lat;
+    double cos_lat;
+    double lng;     // в радианах
+};
+
+inline PreparedCoordinates Prepare(Coordinates coord){
+    return {std::sin(coord.lat * DEG_TO_RAD), std::cos(coord.lat * DEG_TO_RAD), coord.lng * DEG_TO_RAD};
+}
+
+// Набор подготовленных координат в виде отдельных массивов (structure of arrays)
+struct PreparedCoordinatesArray {
+    std::vector<double> sin_lat;
+    std::vector<double> cos_lat;
+    std::vector<double> lng;
+
+    void Reserve(size_t count){
+        sin_lat.reserve(count);
+        cos_lat.reserve(count);
+        lng.reserve(count);
+    }
+    void PushBack(PreparedCoordinates coord){
+        sin_lat.push_back(coord.sin_lat);
+        cos_lat.push_back(coord.cos_lat);
+        lng.push_back(coord.lng);
+    }
+    void Resize(size_t count){
+        sin_lat.resize(count);
+        cos_lat.resize(count);
+        lng.resize(count);
+    }
+    void Set(size_t index, PreparedCoordinates coord){
+        sin_lat[index] = coord.sin_lat;
+        cos_lat[index] = coord.cos_lat;
+        lng[index] = coord.lng;
+    }
+    PreparedCoordinates operator[](size_t index) const {
+        return {sin_lat[index], cos_lat[index], lng[index]};
+    }
+    size_t Size() const {
+        return lng.size();
+    }
+};
+
+// Вычисляет расстояния между парами точек from[i] и to[i], результат пишет в result[i].
+// Тригонометрия широт берётся готовой, на пару остаются один cos и один acos
+void ComputeDistances(const PreparedCoordinatesArray& from, const PreparedCoordinatesArray& to, double* result);
+
 }  // namespace geo
-// } // namespace Catalogue
\ No newline at end of file
+// } // namespace Catalogue
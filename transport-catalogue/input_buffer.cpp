@@ -0,0 +1,99 @@
+#include "input_buffer.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INPUT_BUFFER_HAS_MMAP
+#endif
+
+InputBuffer InputBuffer::FromStdin() {
+    InputBuffer result;
+#ifdef INPUT_BUFFER_HAS_MMAP
+    if (result.Map(STDIN_FILENO)) {
+        return result;
+    }
+#endif
+    return FromStream(std::cin);
+}
+
+InputBuffer InputBuffer::FromFile(const std::string& path) {
+#ifdef INPUT_BUFFER_HAS_MMAP
+    if (const int fd = open(path.c_str(), O_RDONLY); fd >= 0) {
+        InputBuffer result;
+        const bool mapped = result.Map(fd);
+        close(fd);
+        if (mapped) {
+            return result;
+        }
+    }
+#endif
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Can't open file " + path);
+    }
+    return FromStream(input);
+}
+
+InputBuffer InputBuffer::FromStream(std::istream& input) {
+    InputBuffer result;
+    result.buffer_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return result;
+}
+
+InputBuffer::InputBuffer(InputBuffer&& other) noexcept
+    : mapped_(std::exchange(other.mapped_, nullptr))
+    , mapped_size_(std::exchange(other.mapped_size_, 0))
+    , buffer_(std::move(other.buffer_)) {
+}
+
+InputBuffer& InputBuffer::operator=(InputBuffer&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        mapped_ = std::exchange(other.mapped_, nullptr);
+        mapped_size_ = std::exchange(other.mapped_size_, 0);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+InputBuffer::~InputBuffer() {
+    Unmap();
+}
+
+bool InputBuffer::Map([[maybe_unused]] int fd) {
+#ifdef INPUT_BUFFER_HAS_MMAP
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    // Файл читается один раз от начала к концу
+    madvise(data, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+    mapped_ = static_cast<const char*>(data);
+    mapped_size_ = static_cast<size_t>(file_stat.st_size);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void InputBuffer::Unmap() {
+#ifdef INPUT_BUFFER_HAS_MMAP
+    if (mapped_ != nullptr) {
+        munmap(const_cast<char*>(mapped_), mapped_size_);
+    }
+#endif
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+}
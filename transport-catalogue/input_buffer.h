@@ -0,0 +1,39 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <string_view>
+
+/*
+ * Входные данные целиком в непрерывной памяти.
+ * Обычный файл отображается в память через mmap, остальные источники
+ * (pipe, терминал) читаются в буфер
+ */
+class InputBuffer {
+public:
+    // Стандартный ввод: отображается в память, если перенаправлен из файла
+    static InputBuffer FromStdin();
+    static InputBuffer FromFile(const std::string& path);
+    static InputBuffer FromStream(std::istream& input);
+
+    InputBuffer(InputBuffer&& other) noexcept;
+    InputBuffer& operator=(InputBuffer&& other) noexcept;
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+    ~InputBuffer();
+
+    std::string_view GetData() const {
+        return mapped_ != nullptr ? std::string_view(mapped_, mapped_size_) : std::string_view(buffer_);
+    }
+
+private:
+    InputBuffer() = default;
+
+    // Возвращает false, если файл не удалось отобразить в память
+    bool Map(int fd);
+    void Unmap();
+
+    const char* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+    std::string buffer_;
+};
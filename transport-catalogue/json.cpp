@@ -1,4 +1,10 @@
 #include "json.h"
+#include "json_scan.h"
+#include "json_writer.h"
+
+#include <charconv>
+#include <iterator>
+#include <limits>
 
 using namespace std;
 
@@ -6,43 +12,108 @@ namespace json {
 
 namespace {
 
-Node LoadNode(istream& input);
-Node LoadString(std::istream& input);
+// Разбирает JSON из непрерывного буфера [begin, end) и сообщает о его элементах обработчику.
+// Повторяет поведение разбора из потока, включая тексты исключений
+template <typename EventHandler>
+class Parser {
+public:
+    Parser(const char* begin, const char* end, EventHandler& handler)
+        : pos_(begin)
+        , end_(end)
+        , handler_(handler) {
+    }
+
+    void ParseNode();
+
+    // Структурный просмотр, см. SplitArray() и SplitDict(). Значения массива передаются
+    // в on_chunk(std::vector<std::string_view>&) кусками не длиннее chunk_size
+    template <typename OnChunk>
+    bool SplitArray(size_t chunk_size, OnChunk&& on_chunk);
+    std::optional<std::vector<std::pair<std::string, std::string_view>>> SplitDict();
+
+private:
+    const char* pos_;
+    const char* end_;
+    EventHandler& handler_;
+    // Сюда раскрываются escape-последовательности; строки без них не копируются
+    std::string string_buffer_;
 
-std::string LoadLiteral(std::istream& input) {
-    std::string s;
-    while (std::isalpha(input.peek())) {
-        s.push_back(static_cast<char>(input.get()));
+    static bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
     }
-    return s;
+    static bool IsAlpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    // Аналог input >> c: пропускает пробельные символы и читает следующий символ
+    bool ReadChar(char& c) {
+        pos_ = scan::SkipWhitespace(pos_, end_);
+        if (pos_ == end_) {
+            return false;
+        }
+        c = *pos_++;
+        return true;
+    }
+    // Аналог input.peek(): -1 в конце буфера
+    int Peek() const {
+        return pos_ != end_ ? static_cast<unsigned char>(*pos_) : -1;
+    }
+
+    std::string_view ParseLiteral();
+    void ParseArray();
+    void ParseDict();
+    // Возвращённая строка действительна до следующего вызова ParseString
+    std::string_view ParseString();
+    void ParseBool();
+    void ParseNull();
+    void ParseNumber();
+
+    // Пропускает значение, не разбирая его, и возвращает его текст.
+    // Проверяются только парность кавычек и скобок, остальное - забота разбора значения
+    std::string_view SkipValue();
+    // Пропускает строку после открывающей кавычки
+    void SkipString();
+};
+
+template <typename EventHandler>
+std::string_view Parser<EventHandler>::ParseLiteral() {
+    const char* begin = pos_;
+    while (pos_ != end_ && IsAlpha(*pos_)) {
+        ++pos_;
+    }
+    return {begin, static_cast<size_t>(pos_ - begin)};
 }
 
-Node LoadArray(std::istream& input) {
-    std::vector<Node> result;
+template <typename EventHandler>
+void Parser<EventHandler>::ParseArray() {
+    handler_.StartArray();
 
-    for (char c; input >> c && c != ']';) {
+    char c;
+    bool has_input = true;
+    while ((has_input = ReadChar(c)) && c != ']') {
         if (c != ',') {
-            input.putback(c);
+            --pos_;
         }
-        result.push_back(LoadNode(input));
+        ParseNode();
     }
-    if (!input) {
+    if (!has_input) {
         throw ParsingError("Array parsing error"s);
     }
-    return Node(std::move(result));
+    handler_.EndArray();
 }
 
-Node LoadDict(std::istream& input) {
-    Dict dict;
+template <typename EventHandler>
+void Parser<EventHandler>::ParseDict() {
+    handler_.StartDict();
 
-    for (char c; input >> c && c != '}';) {
+    char c;
+    bool has_input = true;
+    while ((has_input = ReadChar(c)) && c != '}') {
         if (c == '"') {
-            std::string key = LoadString(input).AsString();
-            if (input >> c && c == ':') {
-                if (dict.find(key) != dict.end()) {
-                    throw ParsingError("Duplicate key '"s + key + "' have been found");
-                }
-                dict.emplace(std::move(key), LoadNode(input));
+            const std::string_view key = ParseString();
+            if (ReadChar(c) && c == ':') {
+                handler_.Key(key);
+                ParseNode();
             } else {
                 throw ParsingError(": is expected but '"s + c + "' has been found"s);
             }
@@ -50,30 +121,35 @@ Node LoadDict(std::istream& input) {
             throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
         }
     }
-    if (!input) {
+    if (!has_input) {
         throw ParsingError("Dictionary parsing error"s);
     }
-    return Node(std::move(dict));
+    handler_.EndDict();
 }
 
-Node LoadString(std::istream& input) {
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    std::string s;
+template <typename EventHandler>
+std::string_view Parser<EventHandler>::ParseString() {
+    const char* begin = pos_;
+    pos_ = scan::FindStringSpecial(pos_, end_);
+    if (pos_ != end_ && *pos_ == '"') {
+        // Строка без escape-последовательностей отдаётся прямо из буфера
+        return {begin, static_cast<size_t>(pos_++ - begin)};
+    }
+
+    std::string& s = string_buffer_;
+    s.assign(begin, pos_);
     while (true) {
-        if (it == end) {
+        if (pos_ == end_) {
             throw ParsingError("String parsing error");
         }
-        const char ch = *it;
+        const char ch = *pos_++;
         if (ch == '"') {
-            ++it;
             break;
         } else if (ch == '\\') {
-            ++it;
-            if (it == end) {
+            if (pos_ == end_) {
                 throw ParsingError("String parsing error");
             }
-            const char escaped_char = *(it);
+            const char escaped_char = *pos_++;
             switch (escaped_char) {
                 case 'n':
                     s.push_back('\n');
@@ -93,63 +169,60 @@ Node LoadString(std::istream& input) {
                 default:
                     throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
             }
-        } else if (ch == '\n' || ch == '\r') {
-            throw ParsingError("Unexpected end of line"s);
         } else {
-            s.push_back(ch);
+            throw ParsingError("Unexpected end of line"s);
         }
-        ++it;
+
+        // Участок без спецсимволов копируется целиком
+        const char* run_begin = pos_;
+        pos_ = scan::FindStringSpecial(pos_, end_);
+        s.append(run_begin, pos_);
     }
 
-    return Node(std::move(s));
+    return s;
 }
 
-Node LoadBool(std::istream& input) {
-    const auto s = LoadLiteral(input);
+template <typename EventHandler>
+void Parser<EventHandler>::ParseBool() {
+    const auto s = ParseLiteral();
     if (s == "true"sv) {
-        return Node{true};
+        handler_.Bool(true);
     } else if (s == "false"sv) {
-        return Node{false};
+        handler_.Bool(false);
     } else {
-        throw ParsingError("Failed to parse '"s + s + "' as bool"s);
+        throw ParsingError("Failed to parse '"s + std::string(s) + "' as bool"s);
     }
 }
 
-Node LoadNull(std::istream& input) {
-    if (auto literal = LoadLiteral(input); literal == "null"sv) {
-        return Node{nullptr};
+template <typename EventHandler>
+void Parser<EventHandler>::ParseNull() {
+    if (auto literal = ParseLiteral(); literal == "null"sv) {
+        handler_.Null();
     } else {
-        throw ParsingError("Failed to parse '"s + literal + "' as null"s);
+        throw ParsingError("Failed to parse '"s + std::string(literal) + "' as null"s);
     }
 }
 
-Node LoadNumber(std::istream& input) {
-    std::string parsed_num;
-
-    // Считывает в parsed_num очередной символ из input
-    auto read_char = [&parsed_num, &input] {
-        parsed_num += static_cast<char>(input.get());
-        if (!input) {
-            throw ParsingError("Failed to read number from stream"s);
-        }
-    };
+template <typename EventHandler>
+void Parser<EventHandler>::ParseNumber() {
+    const char* begin = pos_;
 
-    // Считывает одну или более цифр в parsed_num из input
-    auto read_digits = [&input, read_char] {
-        if (!std::isdigit(input.peek())) {
+    // Считывает одну или более цифр
+    auto read_digits = [this] {
+        if (!IsDigit(static_cast<char>(Peek()))) {
             throw ParsingError("A digit is expected"s);
         }
-        while (std::isdigit(input.peek())) {
-            read_char();
+        while (pos_ != end_ && IsDigit(*pos_)) {
+            ++pos_;
         }
     };
 
-    if (input.peek() == '-') {
-        read_char();
+    if (Peek() == '-') {
+        ++pos_;
     }
     // Парсим целую часть числа
-    if (input.peek() == '0') {
-        read_char();
+    if (Peek() == '0') {
+        ++pos_;
         // После 0 в JSON не могут идти другие цифры
     } else {
         read_digits();
@@ -157,50 +230,56 @@ Node LoadNumber(std::istream& input) {
 
     bool is_int = true;
     // Парсим дробную часть числа
-    if (input.peek() == '.') {
-        read_char();
+    if (Peek() == '.') {
+        ++pos_;
         read_digits();
         is_int = false;
     }
 
     // Парсим экспоненциальную часть числа
-    if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    if (int ch = Peek(); ch == 'e' || ch == 'E') {
+        ++pos_;
+        if (ch = Peek(); ch == '+' || ch == '-') {
+            ++pos_;
         }
         read_digits();
         is_int = false;
     }
 
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return std::stoi(parsed_num);
-            } catch (...) {
-                // В случае неудачи, например, при переполнении
-                // код ниже попробует преобразовать строку в double
-            }
+    // Запись числа уже проверена выше, поэтому from_chars разбирает её целиком
+    if (is_int) {
+        // Сначала пробуем преобразовать строку в int
+        int value;
+        // В случае неудачи, например, при переполнении,
+        // код ниже попробует преобразовать строку в double
+        if (std::from_chars(begin, pos_, value).ec == std::errc{}) {
+            handler_.Int(value);
+            return;
         }
-        return std::stod(parsed_num);
-    } catch (...) {
-        throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
     }
+    double value;
+    if (std::from_chars(begin, pos_, value).ec != std::errc{}) {
+        throw ParsingError("Failed to convert "s + std::string(begin, pos_) + " to number"s);
+    }
+    handler_.Double(value);
 }
 
-Node LoadNode(std::istream& input) {
+template <typename EventHandler>
+void Parser<EventHandler>::ParseNode() {
     char c;
-    if (!(input >> c)) {
+    if (!ReadChar(c)) {
         throw ParsingError("Unexpected EOF"s);
     }
     switch (c) {
         case '[':
-            return LoadArray(input);
+            ParseArray();
+            break;
         case '{':
-            return LoadDict(input);
+            ParseDict();
+            break;
         case '"':
-            return LoadString(input);
+            handler_.String(ParseString());
+            break;
         case 't':
             // Атрибут [[fallthrough]] (провалиться) ничего не делает, и является
             // подсказкой компилятору и человеку, что здесь программист явно задумывал
@@ -210,17 +289,207 @@ Node LoadNode(std::istream& input) {
             // литералов true либо false
             [[fallthrough]];
         case 'f':
-            input.putback(c);
-            return LoadBool(input);
+            --pos_;
+            ParseBool();
+            break;
         case 'n':
-            input.putback(c);
-            return LoadNull(input);
+            --pos_;
+            ParseNull();
+            break;
         default:
-            input.putback(c);
-            return LoadNumber(input);
+            --pos_;
+            ParseNumber();
+            break;
+    }
+}
+
+template <typename EventHandler>
+template <typename OnChunk>
+bool Parser<EventHandler>::SplitArray(size_t chunk_size, OnChunk&& on_chunk) {
+    char c;
+    if (!ReadChar(c) || c != '[') {
+        return false;
     }
+    // Разделители проверяются так же, как в ParseArray
+    std::vector<std::string_view> elements;
+    bool has_input = true;
+    while ((has_input = ReadChar(c)) && c != ']') {
+        if (c != ',') {
+            --pos_;
+        }
+        elements.push_back(SkipValue());
+        if (elements.size() == chunk_size) {
+            on_chunk(elements);
+            elements.clear();
+        }
+    }
+    if (!has_input) {
+        throw ParsingError("Array parsing error"s);
+    }
+    if (!elements.empty()) {
+        on_chunk(elements);
+    }
+    return true;
 }
 
+template <typename EventHandler>
+std::optional<std::vector<std::pair<std::string, std::string_view>>> Parser<EventHandler>::SplitDict() {
+    char c;
+    if (!ReadChar(c) || c != '{') {
+        return std::nullopt;
+    }
+    // Разделители и ключи проверяются так же, как в ParseDict и TreeBuilder
+    std::vector<std::pair<std::string, std::string_view>> items;
+    bool has_input = true;
+    while ((has_input = ReadChar(c)) && c != '}') {
+        if (c == '"') {
+            std::string key(ParseString());
+            if (!ReadChar(c) || c != ':') {
+                throw ParsingError(": is expected but '"s + c + "' has been found"s);
+            }
+            const auto is_same_key = [&key](const auto& item) {
+                return item.first == key;
+            };
+            if (std::any_of(items.begin(), items.end(), is_same_key)) {
+                throw ParsingError("Duplicate key '"s + key + "' have been found");
+            }
+            items.emplace_back(std::move(key), SkipValue());
+        } else if (c != ',') {
+            throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
+        }
+    }
+    if (!has_input) {
+        throw ParsingError("Dictionary parsing error"s);
+    }
+    return items;
+}
+
+template <typename EventHandler>
+std::string_view Parser<EventHandler>::SkipValue() {
+    pos_ = scan::SkipWhitespace(pos_, end_);
+    const char* begin = pos_;
+    if (pos_ == end_) {
+        return {};
+    }
+    if (*pos_ == '"') {
+        ++pos_;
+        SkipString();
+    } else if (*pos_ == '[' || *pos_ == '{') {
+        ++pos_;
+        int depth = 1;
+        while (depth > 0) {
+            pos_ = scan::FindStructural(pos_, end_);
+            if (pos_ == end_) {
+                break;
+            }
+            switch (*pos_++) {
+                case '"':
+                    SkipString();
+                    break;
+                case '[':
+                case '{':
+                    ++depth;
+                    break;
+                default:
+                    --depth;
+                    break;
+            }
+        }
+    } else {
+        // Число или литерал тянется до разделителя
+        while (pos_ != end_ && *pos_ != ',' && *pos_ != ']' && *pos_ != '}' && !scan::IsSpace(*pos_)) {
+            ++pos_;
+        }
+    }
+    return {begin, static_cast<size_t>(pos_ - begin)};
+}
+
+template <typename EventHandler>
+void Parser<EventHandler>::SkipString() {
+    while (true) {
+        pos_ = scan::FindStringSpecial(pos_, end_);
+        if (pos_ == end_) {
+            return;
+        }
+        const char c = *pos_++;
+        if (c == '"') {
+            return;
+        }
+        if (c == '\\' && pos_ != end_) {
+            ++pos_;
+        }
+    }
+}
+
+// Обработчик для структурного просмотра: события не порождаются
+struct NoEvents {};
+
+// Собирает дерево Node из событий разбора
+class TreeBuilder {
+public:
+    void StartDict() {
+        containers_.emplace_back(Dict{});
+    }
+    void Key(std::string_view key) {
+        const Dict& dict = std::get<Dict>(containers_.back().GetValue());
+        if (dict.find(key) != dict.end()) {
+            throw ParsingError("Duplicate key '"s + std::string(key) + "' have been found");
+        }
+        keys_.emplace_back(key);
+    }
+    void EndDict() {
+        EndContainer();
+    }
+    void StartArray() {
+        containers_.emplace_back(Array{});
+    }
+    void EndArray() {
+        EndContainer();
+    }
+    void Null() {
+        AddNode(Node{nullptr});
+    }
+    void Bool(bool value) {
+        AddNode(Node{value});
+    }
+    void Int(int value) {
+        AddNode(Node{value});
+    }
+    void Double(double value) {
+        AddNode(Node{value});
+    }
+    void String(std::string_view value) {
+        AddNode(Node{std::string(value)});
+    }
+
+    Node TakeRoot() {
+        return std::move(root_);
+    }
+
+private:
+    Node root_;
+    // Открытые массивы и словари, в конце - самый вложенный
+    std::vector<Node> containers_;
+    // Ключи открытых словарей, ожидающие значения
+    std::vector<std::string> keys_;
+
+    void AddNode(Node node) {
+        if (containers_.empty()) {
+            root_ = std::move(node);
+        } else if (containers_.back().IsArray()) {
+            containers_.back().AsArray().push_back(std::move(node));
+        } else {
+            containers_.back().AsMap().emplace(std::move(keys_.back()), std::move(node));
+            keys_.pop_back();
+        }
+    }
+    void EndContainer() {
+        Node container = std::move(containers_.back());
+        containers_.pop_back();
+        AddNode(std::move(container));
+    }
+};
+
 }  // namespace
 
 
@@ -278,9 +547,9 @@ bool Node::AsBool() const{
     }
     throw (std::logic_error("not Bool"));
 }
-const string& Node::AsString() const {
-    if (IsString()){
-        return std::get<std::string>(data_);
+std::string_view Node::AsString() const {
+    if (const auto* str = std::get_if<std::string>(&data_)){
+        return *str;
     }
     throw (std::logic_error("not String"));
 }
@@ -312,6 +581,9 @@ bool Node::IsMap() const{
 }
 
 bool Node::operator == (const Node &rhs) const {
+    if(IsString() && rhs.IsString()){
+        return AsString() == rhs.AsString();
+    }
     if(data_.index() == rhs.data_.index()){
         return data_ == rhs.data_;
     }
@@ -321,22 +593,6 @@ bool Node::operator != (const Node &rhs) const{
     return !(*this == rhs);
 }
 
-struct PrintContext {
-    std::ostream& out;
-    int indent_step = 4;
-    int indent = 0;
-
-    void PrintIndent() const {
-        for (int i = 0; i < indent; ++i) {
-            out.put(' ');
-        }
-    }
-
-    PrintContext Indented() const {
-        return {out, indent_step, indent_step + indent};
-    }
-};
-
 /*----------------Document-----------*/
 Document::Document(Node root)
     : root_(move(root)) {
@@ -347,102 +603,103 @@ const Node& Document::GetRoot() const {
 }
 
 bool Document::operator == (const Document &rhs) const{
-    return root_ == rhs.GetRoot();
+    return GetRoot() == rhs.GetRoot();
 }
 bool Document::operator != (const Document &rhs) const{
-    return !(root_ == rhs.GetRoot());
+    return !(GetRoot() == rhs.GetRoot());
+}
+
+Document Load(std::string_view input) {
+    TreeBuilder builder;
+    Parser(input.data(), input.data() + input.size(), builder).ParseNode();
+    return Document{builder.TakeRoot()};
 }
 
 Document Load(istream& input) {
-    return Document{LoadNode(input)};
+    const std::string buffer{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    return Load(std::string_view(buffer));
 }
 
-void PrintNode(const Node& node, const PrintContext& context);
+void Parse(std::string_view input, Handler& handler) {
+    Parser(input.data(), input.data() + input.size(), handler).ParseNode();
+}
+
+void Parse(std::istream& input, Handler& handler) {
+    const std::string buffer{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    Parse(std::string_view(buffer), handler);
+}
+
+std::optional<std::vector<std::string_view>> SplitArray(std::string_view input) {
+    NoEvents no_events;
+    std::vector<std::string_view> elements;
+    const bool is_array = Parser(input.data(), input.data() + input.size(), no_events)
+        .SplitArray(std::numeric_limits<size_t>::max(), [&elements](std::vector<std::string_view>& chunk) {
+            elements = std::move(chunk);
+        });
+    if (!is_array) {
+        return std::nullopt;
+    }
+    return elements;
+}
+
+bool SplitArray(std::string_view input, size_t chunk_size,
+                const std::function<void(const std::vector<std::string_view>&)>& on_chunk) {
+    NoEvents no_events;
+    return Parser(input.data(), input.data() + input.size(), no_events).SplitArray(chunk_size, on_chunk);
+}
+
+std::optional<std::vector<std::pair<std::string, std::string_view>>> SplitDict(std::string_view input) {
+    NoEvents no_events;
+    return Parser(input.data(), input.data() + input.size(), no_events).SplitDict();
+}
+
+namespace {
+
+struct NodeTraverser {
+    Handler& handler;
 
-struct NodePrinter {
-    const PrintContext& context;
     void operator()(std::nullptr_t) const {
-        context.out  << "null"sv;
+        handler.Null();
     }
     void operator()(int data) const {
-        context.out  << data;
+        handler.Int(data);
     }
     void operator()(double data) const {
-        context.out  << data;
+        handler.Double(data);
     }
     void operator()(bool data) const {
-        context.out << std::boolalpha << data;
-    }
-    void operator()(std::string data) const {
-        context.out.put('"');
-        for (const char c : data) {
-            switch (c) {
-                case '\r':
-                    context.out << "\\r"sv;
-                    break;
-                case '\n':
-                    context.out << "\\n"sv;
-                    break;
-                case '\t':
-                    context.out << "\\t"sv;
-                    break;
-                case '"':
-                    // Символы " и \ выводятся как \" или \\, соответственно
-                    [[fallthrough]];
-                case '\\':
-                    context.out.put('\\');
-                    [[fallthrough]];
-                default:
-                    context.out.put(c);
-                    break;
-            }
-        }
-        context.out.put('"');
+        handler.Bool(data);
     }
-    void operator()(Array data) const {
-        context.out << "[\n"sv;
-        bool first = true;
-        auto inner_ctx = context.Indented();
+    void operator()(const std::string& data) const {
+        handler.String(data);
+    }
+    void operator()(const Array& data) const {
+        handler.StartArray();
         for (const Node& node : data) {
-            if (first) {
-                first = false;
-            } else {
-                context.out << ",\n"sv;
-            }
-            inner_ctx.PrintIndent();
-            PrintNode(node, inner_ctx);
+            Traverse(node, handler);
         }
-        context.out.put('\n');
-        context.PrintIndent();
-        context.out.put(']');
-    }
-    void operator()(Dict data) const {
-        context.out << "{\n"sv;
-        bool first = true;
-        auto inner_ctx = context.Indented();
+        handler.EndArray();
+    }
+    void operator()(const Dict& data) const {
+        handler.StartDict();
         for (const auto& [key, node] : data) {
-            if (first) {
-                first = false;
-            } else {
-                context.out << ",\n"sv;
-            }
-            inner_ctx.PrintIndent();
-            PrintNode(key, inner_ctx);
-            context.out << ": "sv;
-            PrintNode(node, inner_ctx);
+            handler.Key(key);
+            Traverse(node, handler);
         }
-        context.out.put('\n');
-        context.PrintIndent();
-        context.out.put('}');
+        handler.EndDict();
     }
 };
 
-void Print(const Document& doc, std::ostream& output) {
-    PrintNode(doc.GetRoot(), PrintContext{output});
+}  // namespace
+
+void Traverse(const Node& node, Handler& handler) {
+    std::visit(NodeTraverser{handler}, node.GetValue());
 }
 
-void PrintNode(const Node& node, const PrintContext& context) {
-    std::visit(NodePrinter{context}, node.GetValue());
+void Print(const Document& doc, std::ostream& output) {
+    Writer writer(output);
+    writer.Value(doc.GetRoot());
+    writer.Flush();
 }
 
 }  // namespace json
\ No newline at end of file
@@ -1,18 +1,66 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
-#include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include <variant>
 
 namespace json {
 
 class Node;
-// Сохраните объявления Dict и Array без изменения
-using Dict = std::map<std::string, Node>;
 using Array = std::vector<Node>;
 
+// Словарь - отсортированный по ключу вектор пар. Порядок обхода тот же, что у std::map,
+// а поиск - бинарный по непрерывному массиву, в том числе по std::string_view без копирования ключа.
+// Ключи в векторе не константны, поэтому наружу выдаются только константные итераторы:
+// изменить ключ и нарушить порядок нельзя, значения меняются через at() и operator[]
+class Dict {
+public:
+    using value_type = std::pair<std::string, Node>;
+    using Items = std::vector<value_type>;
+    using const_iterator = Items::const_iterator;
+    using iterator = const_iterator;
+
+    // Тела методов - после Node: до этого value_type - неполный тип
+    Dict();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_t size() const;
+    bool empty() const;
+    void reserve(size_t count);
+
+    const_iterator find(std::string_view key) const;
+    size_t count(std::string_view key) const;
+    // Как у std::map: std::out_of_range, если ключа нет
+    const Node& at(std::string_view key) const;
+    Node& at(std::string_view key);
+    Node& operator[](std::string_view key);
+
+    // Как у std::map: существующее значение не заменяется
+    template <typename Key, typename... Args>
+    std::pair<const_iterator, bool> emplace(Key&& key, Args&&... args);
+    std::pair<const_iterator, bool> insert(value_type item);
+
+    bool operator == (const Dict& rhs) const;
+    bool operator != (const Dict& rhs) const;
+
+private:
+    Items items_;
+
+    // Общий поиск для константного и неконстантного вектора
+    template <typename ItemsRef>
+    static auto LowerBound(ItemsRef& items, std::string_view key) -> decltype(items.begin());
+    template <typename Key, typename... Args>
+    std::pair<Items::iterator, bool> EmplaceItem(Key&& key, Args&&... args);
+};
+
 // Эта ошибка должна выбрасываться при ошибках парсинга JSON
 class ParsingError : public std::runtime_error {
 public:
@@ -29,13 +77,13 @@ public:
 
     template<typename T>
     Node(T data)
-    :data_(data){}
+    :data_(std::move(data)){}
 
     const Value& GetValue() const;
 
     int AsInt() const;
     double AsDouble() const;
-    const std::string& AsString() const;
+    std::string_view AsString() const;
     bool AsBool() const;
     const Array& AsArray() const;
     Array& AsArray();
@@ -58,6 +106,97 @@ private:
     Value data_;
 };
 
+/*---------------Dict------------------*/
+
+inline Dict::Dict() = default;
+
+inline Dict::const_iterator Dict::begin() const {
+    return items_.begin();
+}
+
+inline Dict::const_iterator Dict::end() const {
+    return items_.end();
+}
+
+inline size_t Dict::size() const {
+    return items_.size();
+}
+
+inline bool Dict::empty() const {
+    return items_.empty();
+}
+
+inline void Dict::reserve(size_t count) {
+    items_.reserve(count);
+}
+
+inline size_t Dict::count(std::string_view key) const {
+    return find(key) != end() ? 1 : 0;
+}
+
+template <typename ItemsRef>
+auto Dict::LowerBound(ItemsRef& items, std::string_view key) -> decltype(items.begin()) {
+    // Ключи часто приходят по возрастанию, тогда новый ключ встаёт в конец без поиска
+    if (items.empty() || std::string_view(items.back().first) < key) {
+        return items.end();
+    }
+    return std::lower_bound(items.begin(), items.end(), key,
+                            [](const value_type& item, std::string_view rhs) { return std::string_view(item.first) < rhs; });
+}
+
+inline Dict::const_iterator Dict::find(std::string_view key) const {
+    const auto it = LowerBound(items_, key);
+    return it != end() && it->first == key ? it : end();
+}
+
+inline const Node& Dict::at(std::string_view key) const {
+    if (const auto it = find(key); it != end()) {
+        return it->second;
+    }
+    throw std::out_of_range("Dict::at");
+}
+
+inline Node& Dict::at(std::string_view key) {
+    if (const auto it = LowerBound(items_, key); it != items_.end() && it->first == key) {
+        return it->second;
+    }
+    throw std::out_of_range("Dict::at");
+}
+
+inline Node& Dict::operator[](std::string_view key) {
+    return EmplaceItem(key).first->second;
+}
+
+template <typename Key, typename... Args>
+std::pair<Dict::const_iterator, bool> Dict::emplace(Key&& key, Args&&... args) {
+    return EmplaceItem(std::forward<Key>(key), std::forward<Args>(args)...);
+}
+
+template <typename Key, typename... Args>
+std::pair<Dict::Items::iterator, bool> Dict::EmplaceItem(Key&& key, Args&&... args) {
+    const std::string_view key_view(key);
+    const auto it = LowerBound(items_, key_view);
+    if (it != items_.end() && it->first == key_view) {
+        return {it, false};
+    }
+    return {items_.emplace(it, std::piecewise_construct,
+                           std::forward_as_tuple(std::forward<Key>(key)),
+                           std::forward_as_tuple(std::forward<Args>(args)...)),
+            true};
+}
+
+inline std::pair<Dict::const_iterator, bool> Dict::insert(value_type item) {
+    return emplace(std::move(item.first), std::move(item.second));
+}
+
+inline bool Dict::operator == (const Dict& rhs) const {
+    return items_ == rhs.items_;
+}
+
+inline bool Dict::operator != (const Dict& rhs) const {
+    return !(*this == rhs);
+}
+
 class Document {
 public:
     explicit Document(Node root);
@@ -71,8 +210,48 @@ private:
     Node root_;
 };
 
+// Получатель событий потокового разбора: вместо построения дерева Node
+// парсер сообщает о каждом элементе документа по мере чтения
+class Handler {
+public:
+    virtual void StartDict() = 0;
+    virtual void Key(std::string_view key) = 0;
+    virtual void EndDict() = 0;
+    virtual void StartArray() = 0;
+    virtual void EndArray() = 0;
+    virtual void Null() = 0;
+    virtual void Bool(bool value) = 0;
+    virtual void Int(int value) = 0;
+    virtual void Double(double value) = 0;
+    // Ключи и строки действительны только на время вызова
+    virtual void String(std::string_view value) = 0;
+protected:
+    ~Handler() = default;
+};
+
+// Разбирает документ из непрерывного буфера
+Document Load(std::string_view input);
+// Читает поток до конца и разбирает прочитанное как Load(std::string_view)
 Document Load(std::istream& input);
 
+// Потоковый разбор: те же правила и исключения, что у Load, но без построения дерева
+void Parse(std::string_view input, Handler& handler);
+void Parse(std::istream& input, Handler& handler);
+// Передаёт узел в handler теми же событиями, что Parse - его текст
+void Traverse(const Node& node, Handler& handler);
+
+// Структурный просмотр массива или словаря: текст каждого значения находится без его разбора,
+// так что значения можно разбирать потом, в том числе параллельно. Разделители, ключи
+// и их уникальность проверяются как у Load, сами значения - только на парность скобок.
+// Если input не начинается с '[' ('{'), возвращается nullopt
+std::optional<std::vector<std::string_view>> SplitArray(std::string_view input);
+// То же по кускам: текст значений передаётся в on_chunk порциями не длиннее chunk_size,
+// так что память под разметку не зависит от длины массива. Куски до синтаксической
+// ошибки успевают передаться. Возвращает false, если input не начинается с '['
+bool SplitArray(std::string_view input, size_t chunk_size,
+                const std::function<void(const std::vector<std::string_view>&)>& on_chunk);
+std::optional<std::vector<std::pair<std::string, std::string_view>>> SplitDict(std::string_view input);
+
 void Print(const Document& doc, std::ostream& output);
 
-}  // namespace json
\ No newline at end of file
+}  // namespace json
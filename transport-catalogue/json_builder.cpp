@@ -27,7 +27,7 @@ Builder::BaseContext Builder::Value(Node::Value value){
     }else if(nodes_stack_.back()->IsString()){
         Node* key = nodes_stack_.back();
         nodes_stack_.pop_back();
-        nodes_stack_.back()->AsMap().insert({std::move((*key).AsString()), std::move(value)});
+        nodes_stack_.back()->AsMap().emplace(key->AsString(), std::move(value));
     }else{
         throw std::logic_error("Value in wrong place");
     }
@@ -99,9 +99,124 @@ void Builder::EndConatiner(){
     }else if(nodes_stack_.back()->IsString()){
         Node* key = nodes_stack_.back();
         nodes_stack_.pop_back();
-        nodes_stack_.back()->AsMap().insert({std::move((*key).AsString()), std::move(*node)});
+        nodes_stack_.back()->AsMap().emplace(key->AsString(), std::move(*node));
     }
 
 }
 
+/*---------------StreamBuilder------------------*/
+
+StreamBuilder::StreamBuilder(Writer& writer)
+    :writer_(writer){
+}
+
+StreamBuilder::DictValueContext StreamBuilder::Key(std::string_view key){
+    CheckContext(Commands::KEY);
+    writer_.Key(key);
+    return BaseContext{*this};
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(std::nullptr_t){
+    CheckContext(Commands::VALUE);
+    writer_.Null();
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(bool value){
+    CheckContext(Commands::VALUE);
+    writer_.Bool(value);
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(int value){
+    CheckContext(Commands::VALUE);
+    writer_.Int(value);
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(double value){
+    CheckContext(Commands::VALUE);
+    writer_.Double(value);
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(std::string_view value){
+    CheckContext(Commands::VALUE);
+    writer_.String(value);
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(const std::string& value){
+    return Value(std::string_view(value));
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(const char* value){
+    return Value(std::string_view(value));
+}
+
+StreamBuilder::BaseContext StreamBuilder::Value(const Node& node){
+    CheckContext(Commands::VALUE);
+    writer_.Value(node);
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::DictItemContext StreamBuilder::StartDict(){
+    CheckContext(Commands::START_DICT);
+    writer_.StartDict();
+    ++depth_;
+    return BaseContext{*this};
+}
+
+StreamBuilder::ArrayItemContext StreamBuilder::StartArray(){
+    CheckContext(Commands::START_ARRAY);
+    writer_.StartArray();
+    ++depth_;
+    return BaseContext{*this};
+}
+
+StreamBuilder::BaseContext StreamBuilder::EndDict(){
+    CheckContext(Commands::END_DICT);
+    writer_.EndDict();
+    --depth_;
+    EndValue();
+    return *this;
+}
+
+StreamBuilder::BaseContext StreamBuilder::EndArray(){
+    CheckContext(Commands::END_ARRAY);
+    writer_.EndArray();
+    --depth_;
+    EndValue();
+    return *this;
+}
+
+void StreamBuilder::Build(){
+    if(!done_){
+        throw std::logic_error("Must be one object");
+    }
+}
+
+void StreamBuilder::CheckContext(Commands command) {
+    if(done_ && (command == Commands::KEY || command == Commands::VALUE
+                 || command == Commands::START_ARRAY || command == Commands::START_DICT)){
+        throw std::logic_error("Object already done");
+    }
+    if(depth_ == 0 && (command == Commands::END_ARRAY || command == Commands::END_DICT)){
+        throw std::logic_error("nodes_stack_ empty for end dict or array");
+    }
+}
+
+// Значение верхнего уровня завершает объект
+void StreamBuilder::EndValue(){
+    if(depth_ == 0){
+        done_ = true;
+    }
+}
+
 }
\ No newline at end of file
@@ -2,10 +2,12 @@
 
 
 #include <vector>
-#include <map>
 #include <deque>
+#include <string_view>
+#include <utility>
 
 #include "json.h"
+#include "json_writer.h"
 
 namespace json{
 
@@ -19,12 +21,96 @@ enum Commands{
     BUILD
 };
 
+// Контексты fluent-интерфейса общие для Builder и StreamBuilder
+namespace builder_context {
+
+template <typename Owner> class BaseContext;
+template <typename Owner> class DictValueContext;
+template <typename Owner> class DictItemContext;
+template <typename Owner> class ArrayItemContext;
+
+// Key() → Value(), StartDict(), StartArray()
+// StartDict() → Key(), EndDict()
+// Key() → Value() → Key(), EndDict()
+// StartArray() → Value(), StartDict(), StartArray(), EndArray() 
+// StartArray() → Value() → Value(), StartDict(), StartArray(), EndArray()
+
+template <typename Owner>
+class BaseContext {
+public:
+    BaseContext(Owner& builder) : builder_(builder) {}
+    decltype(auto) Build() {
+        return builder_.Build();
+    }
+    template <typename K>
+    DictValueContext<Owner> Key(K&& key) {
+        return builder_.Key(std::forward<K>(key));
+    }
+    template <typename T>
+    BaseContext Value(T&& value) {
+        return builder_.Value(std::forward<T>(value));
+    }
+    DictItemContext<Owner> StartDict() {
+        return builder_.StartDict();
+    }
+    ArrayItemContext<Owner> StartArray() {
+        return builder_.StartArray();
+    }
+    BaseContext EndDict() {
+        return builder_.EndDict();
+    }
+    BaseContext EndArray() {
+        return builder_.EndArray();
+    }
+private:
+    Owner& builder_;
+};
+
+template <typename Owner>
+class DictValueContext : public BaseContext<Owner> {
+public:
+    DictValueContext(BaseContext<Owner> base) : BaseContext<Owner>(base) {}
+    template <typename T>
+    DictItemContext<Owner> Value(T&& value) { return BaseContext<Owner>::Value(std::forward<T>(value)); }
+    void Build() = delete;
+    template <typename K>
+    void Key(K&& key) = delete;
+    void EndDict() = delete;
+    void EndArray() = delete;
+};
+
+template <typename Owner>
+class DictItemContext : public BaseContext<Owner> {
+public:
+    DictItemContext(BaseContext<Owner> base) : BaseContext<Owner>(base) {}
+    void Build() = delete;
+    template <typename T>
+    void Value(T&& value) = delete;
+    void EndArray() = delete;
+    void StartDict() = delete;
+    void StartArray() = delete;
+};
+
+template <typename Owner>
+class ArrayItemContext : public BaseContext<Owner> {
+public:
+    ArrayItemContext(BaseContext<Owner> base) : BaseContext<Owner>(base) {}
+    template <typename T>
+    ArrayItemContext Value(T&& value) { return BaseContext<Owner>::Value(std::forward<T>(value)); }
+    void Build() = delete;
+    template <typename K>
+    void Key(K&& key) = delete;
+    void EndDict() = delete;
+};
+
+}  // namespace builder_context
+
 class Builder{
 private:
-    class BaseContext;
-    class DictValueContext;
-    class DictItemContext;
-    class ArrayItemContext;
+    using BaseContext = builder_context::BaseContext<Builder>;
+    using DictValueContext = builder_context::DictValueContext<Builder>;
+    using DictItemContext = builder_context::DictItemContext<Builder>;
+    using ArrayItemContext = builder_context::ArrayItemContext<Builder>;
 public:
     
     Builder() = default;
@@ -47,70 +133,46 @@ private:
 
     template<typename T>
     void StartConatiner(T obj);
+};
 
-    // Key() → Value(), StartDict(), StartArray()
-    // StartDict() → Key(), EndDict()
-    // Key() → Value() → Key(), EndDict()
-    // StartArray() → Value(), StartDict(), StartArray(), EndArray() 
-    // StartArray() → Value() → Value(), StartDict(), StartArray(), EndArray()
-
-    class BaseContext {
-    public:
-        BaseContext(Builder& builder) : builder_(builder) {}
-        Node Build() {
-            return builder_.Build();
-        }
-        DictValueContext Key(std::string key) {
-            return builder_.Key(std::move(key));
-        }
-        BaseContext Value(Node::Value value) {
-            return builder_.Value(std::move(value));
-        }
-        DictItemContext StartDict() {
-            return builder_.StartDict();
-        }
-        ArrayItemContext StartArray() {
-            return builder_.StartArray();
-        }
-        BaseContext EndDict() {
-            return builder_.EndDict();
-        }
-        BaseContext EndArray() {
-            return builder_.EndArray();
-        }
-    private:
-        Builder& builder_;
-    };
-
-    class DictValueContext : public BaseContext {
-    public:
-        DictValueContext(BaseContext base) : BaseContext(base) {}
-        DictItemContext Value(Node::Value value) { return BaseContext::Value(std::move(value)); }
-        Node Build() = delete;
-        DictValueContext Key(std::string key) = delete;
-        BaseContext EndDict() = delete;
-        BaseContext EndArray() = delete;
-    };
-
-    class DictItemContext : public BaseContext {
-    public:
-        DictItemContext(BaseContext base) : BaseContext(base) {}
-        Node Build() = delete;
-        BaseContext Value(Node::Value value) = delete;
-        BaseContext EndArray() = delete;
-        DictItemContext StartDict() = delete;
-        ArrayItemContext StartArray() = delete;
-    };
-
-    class ArrayItemContext : public BaseContext {
-    public:
-        ArrayItemContext(BaseContext base) : BaseContext(base) {}
-        ArrayItemContext Value(Node::Value value) { return BaseContext::Value(std::move(value)); }
-        Node Build() = delete;
-        DictValueContext Key(std::string key) = delete;
-        BaseContext EndDict() = delete;
-    };
+// Тот же fluent-интерфейс, что у Builder, но без дерева Node:
+// каждый вызов сразу пишется в Writer, поэтому память под значения не выделяется.
+// Ключи выводятся в порядке вызова Key()
+class StreamBuilder{
+private:
+    using BaseContext = builder_context::BaseContext<StreamBuilder>;
+    using DictValueContext = builder_context::DictValueContext<StreamBuilder>;
+    using DictItemContext = builder_context::DictItemContext<StreamBuilder>;
+    using ArrayItemContext = builder_context::ArrayItemContext<StreamBuilder>;
+public:
 
+    explicit StreamBuilder(Writer& writer);
+
+    DictValueContext Key(std::string_view key);
+    BaseContext Value(std::nullptr_t);
+    BaseContext Value(bool value);
+    BaseContext Value(int value);
+    BaseContext Value(double value);
+    BaseContext Value(std::string_view value);
+    // Строки и литералы иначе неоднозначно приводились бы к Node или к bool
+    BaseContext Value(const std::string& value);
+    BaseContext Value(const char* value);
+    BaseContext Value(const Node& node);
+    DictItemContext StartDict();
+    ArrayItemContext StartArray();
+    BaseContext EndDict();
+    BaseContext EndArray();
+    // Проверяет, что объект записан целиком
+    void Build();
+private:
+
+    Writer& writer_;
+    // Число открытых контейнеров
+    size_t depth_ = 0;
+    bool done_ = false;
+
+    void CheckContext(Commands command);
+    void EndValue();
 };
 
 
@@ -1,322 +1,488 @@
 #include "json_reader.h"
+#include "parallel.h"
+
+#include <atomic>
 
 /*
  * Здесь можно разместить код наполнения транспортного справочника данными из JSON,
  * а также код обработки запросов к базе и формирование массива ответов в формате JSON
  */
 
+/*--------------------- Schema ----------------------------*/
+// Таблицы полей для типизированного чтения разделов запроса
+namespace json::schema {
+
+template <>
+struct Descriptor<CommandDescription> {
+    static constexpr auto fields = std::make_tuple(
+        Optional("type", &CommandDescription::type),
+        Optional("name", &CommandDescription::name),
+        Optional("latitude", &CommandDescription::latitude),
+        Optional("longitude", &CommandDescription::longitude),
+        Optional("road_distances", &CommandDescription::road_distances),
+        Optional("stops", &CommandDescription::stops),
+        Optional("is_roundtrip", &CommandDescription::is_roundtrip));
+};
+
+template <>
+struct Descriptor<DeltaDescription> {
+    static constexpr auto fields = std::make_tuple(
+        Optional("action", &DeltaDescription::action),
+        Optional("type", &DeltaDescription::type),
+        Optional("name", &DeltaDescription::name),
+        Optional("latitude", &DeltaDescription::latitude),
+        Optional("longitude", &DeltaDescription::longitude),
+        Optional("road_distances", &DeltaDescription::road_distances),
+        Optional("stops", &DeltaDescription::stops),
+        Optional("is_roundtrip", &DeltaDescription::is_roundtrip),
+        Optional("from", &DeltaDescription::from),
+        Optional("to", &DeltaDescription::to),
+        Optional("distance", &DeltaDescription::distance));
+};
+
+template <>
+struct Descriptor<RequestDescription> {
+    static constexpr auto fields = std::make_tuple(
+        Optional("id", &RequestDescription::id),
+        Optional("type", &RequestDescription::type),
+        Optional("name", &RequestDescription::name),
+        Optional("from", &RequestDescription::from),
+        Optional("to", &RequestDescription::to));
+};
+
+template <>
+struct Descriptor<routing::Settings> {
+    static constexpr auto fields = std::make_tuple(
+        Required("bus_velocity", &routing::Settings::bus_velocity),
+        Required("bus_wait_time", &routing::Settings::bus_wait_time));
+};
+
+template <>
+struct Descriptor<renderer::RenderSettings> {
+    using Settings = renderer::RenderSettings;
+    static constexpr auto fields = std::make_tuple(
+        Required("width", &Settings::width),
+        Required("height", &Settings::height),
+        Required("padding", &Settings::padding),
+        Required("line_width", &Settings::line_width),
+        Required("stop_radius", &Settings::stop_radius),
+        Required("bus_label_font_size", &Settings::bus_label_font_size),
+        Required("bus_label_offset", &Settings::bus_label_offset),
+        Required("stop_label_font_size", &Settings::stop_label_font_size),
+        Required("stop_label_offset", &Settings::stop_label_offset),
+        Required("underlayer_color", &Settings::underlayer_color),
+        Required("underlayer_width", &Settings::underlayer_width),
+        Required("color_palette", &Settings::color_palette));
+};
+
+// road_distances - словарь "название остановки": расстояние
+template <>
+struct Ops<std::vector<geo::Distance>> {
+    static Target Field(void* object, std::string_view key, uint64_t&) {
+        auto& distances = *static_cast<std::vector<geo::Distance>*>(object);
+        // У остановки обычно несколько соседей, линейный поиск дешевле множества ключей
+        const bool repeated = std::any_of(distances.begin(), distances.end(), [key](const geo::Distance& distance) {
+            return distance.name_location == key;
+        });
+        if (repeated) {
+            throw json::ParsingError("Duplicate key '" + std::string(key) + "' have been found");
+        }
+        return TargetOf(distances.emplace_back(geo::Distance{0, key}).dist);
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Map";
+        result.field = &Field;
+        result.keeps_views = true;
+        return result;
+    }();
+};
+
+// Цвет - строка или массив [r, g, b] либо [r, g, b, opacity], всё прочее - NoneColor
+template <>
+struct Ops<svg::Color> {
+    static svg::Color& Get(void* object) {
+        return *static_cast<svg::Color*>(object);
+    }
+    static void SetNone(void* object) {
+        Get(object) = svg::NoneColor;
+    }
+    template <typename Value>
+    static void SetNone(void* object, Value) {
+        SetNone(object);
+    }
+    static void SetString(void* object, std::string_view value) {
+        Get(object) = std::string(value);
+    }
+    static Target Field(void*, std::string_view, uint64_t&) {
+        return {};
+    }
+    // Компоненты читаются в Rgba, а в конце массива по их числу выбирается тип цвета
+    static Target Element(void* object, uint64_t& state) {
+        if (state == 0) {
+            Get(object) = svg::Rgba{};
+        }
+        auto& rgba = std::get<svg::Rgba>(Get(object));
+        switch (state++) {
+            case 0:
+                return TargetOf(rgba.red);
+            case 1:
+                return TargetOf(rgba.green);
+            case 2:
+                return TargetOf(rgba.blue);
+            case 3:
+                return TargetOf(rgba.opacity);
+            default:
+                return {};
+        }
+    }
+    static void Finish(void* object, uint64_t state) {
+        if (state == 3) {
+            const auto& rgba = std::get<svg::Rgba>(Get(object));
+            Get(object) = svg::Rgb{rgba.red, rgba.green, rgba.blue};
+        } else if (state != 4) {
+            SetNone(object);
+        }
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Array";
+        result.set_null = &SetNone;
+        result.set_bool = &SetNone<bool>;
+        result.set_int = &SetNone<int>;
+        result.set_double = &SetNone<double>;
+        result.set_string = &SetString;
+        result.field = &Field;
+        result.element = &Element;
+        result.finish = &Finish;
+        return result;
+    }();
+};
+
+}  // namespace json::schema
+
 JsonReader::JsonReader(std::istream& input_stream)
-    :input_stream_(input_stream){
+    :input_stream_(&input_stream){
 }
 
-void JsonReader::ReadAndParse(){
-    json::Document document_ = json::Load(input_stream_);
+JsonReader::JsonReader(std::string_view input)
+    :input_(input){
+}
 
-    const json::Dict& doc_as_dict = document_.GetRoot().AsMap();
-    if(const auto base = doc_as_dict.find("base_requests"); base != doc_as_dict.end()){
-        commands_ = std::move(ParseCommands(base->second.AsArray()));
+void JsonReader::ReadAndParse(){
+    std::string_view input = input_;
+    if(input_stream_ != nullptr){
+        input_buffer_.assign(std::istreambuf_iterator<char>(*input_stream_), std::istreambuf_iterator<char>());
+        input = input_buffer_;
+    }
+    strings_.SetInput(input);
+
+    // Корневой словарь только размечается: запоминается, где лежит текст каждого раздела
+    const auto sections = json::SplitDict(input);
+    if(!sections){
+        // Корень - не словарь: ту же ошибку, что и раньше, сообщит обычный разбор
+        json::Load(input).GetRoot().AsMap();
+        return;
     }
+    pending_ = {};
+    for(const auto& [key, text] : *sections){
+        if(key == "base_requests"){
+            pending_.base_requests = text;
+        }else if(key == "routing_settings"){
+            pending_.routing_settings = text;
+        }else if(key == "render_settings"){
+            pending_.render_settings = text;
+        }else if(key == "stat_requests"){
+            pending_.stat_requests = text;
+        }else if(key == "delta_requests"){
+            pending_.delta_requests = text;
+        }
+    }
+}
 
-    if(const auto base = doc_as_dict.find("routing_settings"); base != doc_as_dict.end()){
-        routing_settings_ = std::move(ParseRouteSetting(base->second.AsMap()));
+JsonReader::CommandCounts JsonReader::ParseCommands(std::string_view text, std::vector<CommandDescription>& commands,
+                                                   json::schema::StringStore& strings){
+    const auto elements = json::SplitArray(text);
+    if(!elements){
+        // Не массив: ошибку сообщит обычный разбор
+        commands.clear();
+        json::schema::Parse(text, commands, &strings);
+        return {};
     }
+    return ParseCommandChunk(*elements, commands, strings);
+}
 
-    if(const auto base = doc_as_dict.find("render_settings"); base != doc_as_dict.end()){
-        renderer_ = std::move(ParseRender(base->second.AsMap()));
+JsonReader::CommandCounts JsonReader::ParseCommandChunk(const std::vector<std::string_view>& elements,
+                                                       std::vector<CommandDescription>& commands,
+                                                       json::schema::StringStore& strings){
+    commands.clear();
+    const size_t count = elements.size();
+    if(count == 0){
+        return {};
     }
 
-    if(const auto base = doc_as_dict.find("stat_requests"); base != doc_as_dict.end()){
-        request_ = std::move(ParseRequest(base->second.AsArray()));
-    }  
+    // Команды независимы друг от друга: каждый кусок массива разбирается в своём потоке
+    // прямо на свои места, поэтому порядок сохраняется без слияния. При ошибках наружу
+    // уходит ошибка самого раннего куска, как при последовательном разборе
+    commands.resize(count);
+    std::atomic<size_t> stops{0};
+    std::atomic<size_t> buses{0};
+    parallel::For(count, MIN_COMMANDS_PER_WORKER, [&](size_t begin, size_t end){
+        json::schema::Decoder decoder(&strings);
+        CommandCounts counts;
+        for(size_t i = begin; i < end; ++i){
+            decoder.Reset(commands[i]);
+            json::Parse(elements[i], decoder);
+            if(commands[i].type == "Stop"){
+                ++counts.stops;
+            }else if(commands[i].type == "Bus"){
+                ++counts.buses;
+            }
+        }
+        stops += counts.stops;
+        buses += counts.buses;
+    });
+    return {stops.load(), buses.load()};
 }
 
-void JsonReader::ApplyCommands([[maybe_unused]] catalogue::TransportCatalogue& catalogue) const {
-    for(auto& command : commands_){
-        if(command.command == "Stop"){
-            catalogue.AddStop(command.id.AsString(), ParseCoordinates(command));
-        }
+const std::vector<CommandDescription>& JsonReader::GetCommandsDescription(){
+    if(pending_.base_requests){
+        command_counts_ = ParseCommands(*std::exchange(pending_.base_requests, std::nullopt), commands_, strings_);
     }
-    for(auto& command : commands_){
-        if(command.command == "Stop"){
-            auto distances = ParseDistances(command);
-            for(auto& dist:distances){
-                const auto& stop_from = catalogue.GetStopByName(command.id.AsString());
-                const auto& stop_to = catalogue.GetStopByName(dist.name_location);
-                if(stop_from && stop_to){
-                    catalogue.AddStopsDistance(stop_from.value(), stop_to.value(), dist.dist);
-                }
+    return commands_;
+}
+
+const std::vector<RequestDescription>& JsonReader::GetRequestsDescription(){
+    ParsePending(pending_.stat_requests, request_);
+    return request_;
+}
+
+// Команды передаются справочнику одним пакетом: имена остановок разрешаются
+// и индексы строятся в Freeze(), когда все остановки уже известны.
+// Ещё не разобранные base_requests читаются кусками по COMMANDS_PER_CHUNK команд: описания
+// хранятся только для текущего куска, а в пакет сразу попадают записи со ссылками на текст запроса
+void JsonReader::ApplyCommands([[maybe_unused]] catalogue::TransportCatalogue& catalogue){
+    catalogue::TransportCatalogue::BulkData data;
+    if(pending_.base_requests){
+        const std::string_view text = *std::exchange(pending_.base_requests, std::nullopt);
+        std::vector<CommandDescription> chunk;
+        const bool is_array = json::SplitArray(text, COMMANDS_PER_CHUNK, [&](const std::vector<std::string_view>& elements){
+            ParseCommandChunk(elements, chunk, strings_);
+            for(const auto& command : chunk){
+                AddToBulkData(command, data);
             }
+        });
+        if(!is_array){
+            // Не массив: ошибку сообщит обычный разбор
+            json::schema::Parse(text, chunk, &strings_);
         }
-    }
-    for(auto& command : commands_){
-        if(command.command == "Bus"){
-            catalogue.AddBus(ParseRoute(command, catalogue));
+    }else{
+        data.stops.reserve(command_counts_.stops);
+        data.buses.reserve(command_counts_.buses);
+        for(const auto& command : commands_){
+            AddToBulkData(command, data);
         }
     }
+    // Пакет передаётся после разбора всех кусков, так что синтаксическая ошибка
+    // в конце base_requests не оставляет в справочнике части записей
+    catalogue.Load(std::move(data));
+    catalogue.Freeze();
+}
+
+const std::vector<DeltaDescription>& JsonReader::GetDeltaDescription(){
+    ParsePending(pending_.delta_requests, delta_);
+    return delta_;
+}
+
+void JsonReader::ApplyDelta(catalogue::TransportCatalogue& catalogue){
+    const std::vector<DeltaDescription>& commands = GetDeltaDescription();
+    if(commands.empty()){
+        return;
+    }
+    catalogue::TransportCatalogue::DeltaData data;
+    for(const auto& command : commands){
+        AddToDeltaData(command, data);
+    }
+    catalogue.ApplyDelta(data);
 }
 
-json::Document JsonReader::ApplyRequest(const RequestHandler& handler){
-    json::Array rez_array;
-    for(const auto& element:request_){
-        const auto& type_str = element.type.AsString();
+void JsonReader::ApplyRequest(const RequestHandler& handler, std::ostream& output){
+    // Ответ пишется в поток сразу, как только посчитан, - массив ответов целиком не строится
+    json::Writer writer(output);
+    writer.StartArray();
+    for(const auto& element:GetRequestsDescription()){
+        const auto& type_str = element.type;
         if(type_str == "Bus"){
-            std::optional<catalogue::BusRoutInfo> info = handler.GetBusStat(element.description.at("name").AsString());
-            rez_array.emplace_back(GenerateBusInfo(element.id, info));
+            std::optional<catalogue::BusRoutInfo> info = handler.GetBusStat(element.name);
+            GenerateBusInfo(writer, element.id, info);
         }else if(type_str == "Stop"){
-            const auto info = handler.GetBusesByStop(element.description.at("name").AsString());
-            rez_array.emplace_back(GenerateStopInfo(element.id, info));
+            const auto info = handler.GetBusesByStop(element.name);
+            GenerateStopInfo(writer, element.id, info);
         }else if(type_str == "Map"){
             const auto info = handler.RenderMap();
-            rez_array.emplace_back(GenerateMapInfo(element.id, info));
+            GenerateMapInfo(writer, element.id, info);
         }else if(type_str == "Route"){
-            const auto info = handler.GetRoute(element.description.at("from").AsString(), element.description.at("to").AsString());
-            rez_array.emplace_back(GenerateRouteInfo(element.id, info));
+            const auto info = handler.GetRoute(element.from, element.to);
+            GenerateRouteInfo(writer, element.id, info);
         }
     }
-    return json::Document(rez_array);
-
+    writer.EndArray();
+    writer.Flush();
 }
 
 void JsonReader::ApplyRender(renderer::MapRenderer& renderer){
-    renderer.SetSettings(renderer_);
-}
-
-void JsonReader::ApplyRouter(routing::Settings& settings){
-    settings = routing_settings_;
-}
-
-/*--------------------- Parser ----------------------------*/
-std::vector<CommandDescription> JsonReader::ParseCommands(const json::Array& data) {
-    std::vector<CommandDescription> parsed_commands;
-    for(const auto& command:data){
-        json::Node type;
-        json::Node id;
-        std::unordered_map<std::string, json::Node> description;
-        
-        for(const auto& element:command.AsMap()){
-            if(element.first == "type"){
-                type = element.second;
-            }else if(element.first == "name"){
-                id = element.second;
-            }else{
-                description[element.first] = element.second;
-            }  
-        }
-        parsed_commands.emplace_back(CommandDescription{std::move(type),std::move(id),std::move(description)});
+    if(!HasRequests("Map")){
+        return;
     }
-    return parsed_commands;
+    ParsePending(pending_.render_settings, renderer_);
+    renderer.SetSettings(renderer_);
 }
 
-std::vector<RequestDescription> JsonReader::ParseRequest(const json::Array& data) {
-    std::vector<RequestDescription> parsed_requests;
-    for(const auto& command:data){
-        json::Node type;
-        json::Node id;
-        std::unordered_map<std::string, json::Node> description;
-        
-        for(const auto& [key, value]:command.AsMap()){
-            if(key == "id"){
-                id = value;
-            }else if(key == "type"){
-                type = value;
-            }else{
-                description[key] = value;
-            }  
-        }
-        parsed_requests.emplace_back(RequestDescription{std::move(id), std::move(type),std::move(description)});
+bool JsonReader::ApplyRouter(routing::Settings& settings){
+    if(!HasRequests("Route")){
+        return false;
     }
-    return parsed_requests;
-}
-
-renderer::RenderSettings JsonReader::ParseRender(const json::Dict& data){
-    renderer::RenderSettings settings;
-    settings.width = data.at("width").AsDouble();
-    settings.height = data.at("height").AsDouble();
-    settings.padding = data.at("padding").AsDouble();
-    settings.line_width = data.at("line_width").AsDouble();
-    settings.stop_radius = data.at("stop_radius").AsDouble();
-    settings.bus_label_font_size = data.at("bus_label_font_size").AsInt();
-
-    settings.bus_label_offset[0] = data.at("bus_label_offset").AsArray()[0].AsDouble();
-    settings.bus_label_offset[1] = data.at("bus_label_offset").AsArray()[1].AsDouble();
-
-    settings.stop_label_font_size = data.at("stop_label_font_size").AsInt();
-
-    settings.stop_label_offset[0] = data.at("stop_label_offset").AsArray()[0].AsDouble();
-    settings.stop_label_offset[1] = data.at("stop_label_offset").AsArray()[1].AsDouble();
-    
-    settings.underlayer_color = ParseColor(data.at("underlayer_color"));
-    settings.underlayer_width = data.at("underlayer_width").AsDouble();
-
-    json::Array colorArray = data.at("color_palette").AsArray();
-    for(const auto& element: colorArray){
-        settings.color_palette.emplace_back(ParseColor(element));
-    }
-    return settings;
+    ParsePending(pending_.routing_settings, routing_settings_);
+    settings = routing_settings_;
+    return true;
 }
 
-routing::Settings JsonReader::ParseRouteSetting(const json::Dict& data){
-    routing::Settings settings;
-    settings.bus_velocity = data.at("bus_velocity").AsInt();
-    settings.bus_wait_time = data.at("bus_wait_time").AsInt();
-    return settings;
+bool JsonReader::HasRequests(std::string_view type){
+    const auto& requests = GetRequestsDescription();
+    return std::any_of(requests.begin(), requests.end(), [type](const RequestDescription& request){
+        return request.type == type;
+    });
 }
 
-geo::Coordinates JsonReader::ParseCoordinates(const CommandDescription& data) const{
-    const auto& lat = data.description.find("latitude");
-    const auto& lng = data.description.find("longitude");
-    if(lat !=  data.description.end() &&  lng !=  data.description.end()){
-        return {lat->second.AsDouble(), lng->second.AsDouble()};
+/*--------------------- Parser ----------------------------*/
+geo::Coordinates JsonReader::ParseCoordinates(const CommandDescription& data){
+    if(data.latitude && data.longitude){
+        return {*data.latitude, *data.longitude};
     }
     return {NAN, NAN};
 }
 
-std::vector<geo::Distance> JsonReader::ParseDistances(const CommandDescription& data) const{
-    std::vector<geo::Distance> dists;  
-    const auto& road_distances = data.description.find("road_distances");
-    if(road_distances != data.description.end()){
-        for(const auto& location:road_distances->second.AsMap()){
-            dists.push_back({static_cast<unsigned int>(location.second.AsInt()), location.first});
+void JsonReader::AddToBulkData(const CommandDescription& command, catalogue::TransportCatalogue::BulkData& data){
+    if(command.type == "Stop"){
+        data.stops.push_back({command.name, ParseCoordinates(command)});
+        for(const auto& distance : command.road_distances){
+            data.distances.push_back({command.name, distance.name_location, distance.dist});
         }
+    }else if(command.type == "Bus"){
+        data.buses.push_back({command.name, {command.stops.begin(), command.stops.end()}, command.is_roundtrip});
     }
-    return dists;
 }
 
-catalogue::Bus JsonReader::ParseRoute(const CommandDescription& data, const catalogue::TransportCatalogue& catalogue) const{
-    catalogue::Bus bus;
-    bus.name = data.id.AsString();
-
-    const auto& stops = data.description.find("stops");
-    bool is_roundtrip = false;
-    
-    if(stops !=  data.description.end()){
-        is_roundtrip = data.description.find("is_roundtrip")->second.AsBool();
-        bus.is_roundtrip = is_roundtrip;
-        
-        const auto& stops_as_array = stops->second.AsArray();
-        if(is_roundtrip == true){
-            // Для кольцевого маршрута [A,B,C,A]
-            bus.stops.reserve(stops_as_array.size() + 1);
-            for (auto it = stops_as_array.begin(); it != stops_as_array.end(); ++it) {
-                bus.stops.push_back((catalogue.GetStopByName(it->AsString())).value());
-            }
-
-        } else {
-            // Для некольцевого маршрута [A,B,C,D,C,B,A]
-            bus.stops.reserve(stops_as_array.size() * 2 - 1);
-            for (auto it = stops_as_array.begin(); it != stops_as_array.end(); ++it) {
-                bus.stops.push_back((catalogue.GetStopByName(it->AsString())).value());
-            }
-            for (auto it = stops_as_array.rbegin() + 1; it != stops_as_array.rend(); ++it) {
-                bus.stops.push_back((catalogue.GetStopByName(it->AsString())).value());
-            }
-        }
+void JsonReader::AddToDeltaData(const DeltaDescription& command, catalogue::TransportCatalogue::DeltaData& data){
+    using Action = catalogue::TransportCatalogue::DeltaAction;
+    Action action;
+    if(command.action == "add"){
+        action = Action::ADD;
+    }else if(command.action == "replace"){
+        action = Action::REPLACE;
+    }else if(command.action == "remove"){
+        action = Action::REMOVE;
+    }else{
+        throw std::invalid_argument("Unknown delta action '" + std::string(command.action) + "'");
     }
-    return bus;
-}
 
-svg::Color JsonReader::ParseColor(json::Node data){
-    if(data.IsString()){
-        return data.AsString();
-    }
-    if(data.IsArray()){
-        const auto& colorArray = data.AsArray();
-        if(colorArray.size() == 3) {
-            svg::Rgb rgb;
-            rgb.red = static_cast<uint8_t>(colorArray[0].AsInt());
-            rgb.green = static_cast<uint8_t>(colorArray[1].AsInt());
-            rgb.blue = static_cast<uint8_t>(colorArray[2].AsInt());
-            return rgb;
-        } else if (colorArray.size() == 4) {
-            svg::Rgba rgba;
-            rgba.red = static_cast<uint8_t>(colorArray[0].AsInt());
-            rgba.green = static_cast<uint8_t>(colorArray[1].AsInt());
-            rgba.blue = static_cast<uint8_t>(colorArray[2].AsInt());
-            rgba.opacity = colorArray[3].AsDouble();
-            return rgba;
+    if(command.type == "Stop"){
+        data.stops.push_back({action, {command.name, ParseCoordinates(command)}});
+        if(action != Action::REMOVE){
+            for(const auto& distance : command.road_distances){
+                data.distances.push_back({Action::ADD, {command.name, distance.name_location, distance.dist}});
+            }
         }
+    }else if(command.type == "Bus"){
+        data.buses.push_back({action, {command.name, {command.stops.begin(), command.stops.end()}, command.is_roundtrip}});
+    }else if(command.type == "Distance"){
+        data.distances.push_back({action, {command.from, command.to, command.distance}});
     }
-    return {};
 }
 
 /*--------------------- Part of json request ----------------------------*/
-json::Dict JsonReader::GenerateBusInfo(const json::Node& id, const std::optional<catalogue::BusRoutInfo>& info){
+// Ответы пишутся сразу в writer, ключи - по алфавиту, как их выводит json::Print
+void JsonReader::GenerateBusInfo(json::Writer& writer, int id, const std::optional<catalogue::BusRoutInfo>& info){
     if(!info){
-        return GenerateErrorMessege(id);
+        GenerateErrorMessege(writer, id);
+        return;
     }
-     return json::Builder{}.StartDict()
-                            .Key("request_id").Value(id.GetValue())
-                            .Key("stop_count").Value(static_cast<int>(info->count_stops))
-                            .Key("unique_stop_count").Value(static_cast<int>(info->count_uniq_stops))
+    json::StreamBuilder{writer}.StartDict()
                             .Key("curvature").Value(info->curvature)
+                            .Key("request_id").Value(id)
                             .Key("route_length").Value(static_cast<int>(info->lenght))
-                            .EndDict().Build().AsMap();
+                            .Key("stop_count").Value(static_cast<int>(info->count_stops))
+                            .Key("unique_stop_count").Value(static_cast<int>(info->count_uniq_stops))
+                            .EndDict().Build();
 }
 
-json::Dict JsonReader::GenerateStopInfo(const json::Node& id, const std::optional<std::set<std::string_view>>& info){
+void JsonReader::GenerateStopInfo(json::Writer& writer, int id, const std::optional<std::set<std::string_view>>& info){
 
     if(!info){
-        return GenerateErrorMessege(id);
+        GenerateErrorMessege(writer, id);
+        return;
     }
-    json::Array buses;
+    json::StreamBuilder builder(writer);
+    auto buses = builder.StartDict().Key("buses").StartArray();
     for(const auto& bus:info.value()){
-        buses.emplace_back(std::string(bus));
+        buses.Value(bus);
     }
-     return json::Builder{}.StartDict()
-                            .Key("request_id").Value(id.GetValue())
-                            .Key("buses").Value(std::move(buses))
-                            .EndDict().Build().AsMap();
+    buses.EndArray()
+        .Key("request_id").Value(id)
+        .EndDict().Build();
     
 }
 
-json::Dict JsonReader::GenerateErrorMessege(const json::Node& id){
-    return json::Builder{}.StartDict()
-                            .Key("request_id").Value(id.GetValue())
-                            .Key("error_message").Value(std::string("not found"))
-                            .EndDict().Build().AsMap();
+void JsonReader::GenerateErrorMessege(json::Writer& writer, int id){
+    json::StreamBuilder{writer}.StartDict()
+                            .Key("error_message").Value("not found")
+                            .Key("request_id").Value(id)
+                            .EndDict().Build();
 }
 
-json::Dict JsonReader::GenerateMapInfo(const json::Node& id, const svg::Document& info){
+void JsonReader::GenerateMapInfo(json::Writer& writer, int id, const svg::Document& info){
 
     std::ostringstream stream;
     info.Render(stream);
 
-    return json::Builder{}.StartDict()
+    json::StreamBuilder{writer}.StartDict()
                         .Key("map").Value(stream.str())
-                        .Key("request_id").Value(id.GetValue())
-                        .EndDict().Build().AsMap();
+                        .Key("request_id").Value(id)
+                        .EndDict().Build();
 
 }
 
-json::Dict JsonReader::GenerateRouteInfo(const json::Node& id, std::optional<routing::RouteData> info){
+void JsonReader::GenerateRouteInfo(json::Writer& writer, int id, std::optional<routing::RouteData> info){
 
     if(!info){
-        return GenerateErrorMessege(id);
+        GenerateErrorMessege(writer, id);
+        return;
     }
  
-    json::Array rout_items;
+    json::StreamBuilder builder(writer);
+    auto rout_items = builder.StartDict().Key("items").StartArray();
     for (const auto& part : info.value().parts) {
-        json::Dict dict_tmp;
-        
         if (std::holds_alternative<routing::WaitEdge>(part)) {
             const auto& wait_item = std::get<routing::WaitEdge>(part);
-            dict_tmp["type"] = wait_item.type;
-            dict_tmp["stop_name"] = std::string(wait_item.name);
-            dict_tmp["time"] = wait_item.time;
+            rout_items.StartDict()
+                .Key("stop_name").Value(wait_item.name)
+                .Key("time").Value(wait_item.time)
+                .Key("type").Value(wait_item.type)
+                .EndDict();
         } else if (std::holds_alternative<routing::BusEdge>(part)) {
             const auto& bus_item = std::get<routing::BusEdge>(part);
-            dict_tmp["type"] = bus_item.type;
-            dict_tmp["bus"] = std::string(bus_item.name);
-            dict_tmp["span_count"] = static_cast<int>(bus_item.span_count);
-            dict_tmp["time"] = bus_item.time;
+            rout_items.StartDict()
+                .Key("bus").Value(bus_item.name)
+                .Key("span_count").Value(static_cast<int>(bus_item.span_count))
+                .Key("time").Value(bus_item.time)
+                .Key("type").Value(bus_item.type)
+                .EndDict();
         } 
-        rout_items.push_back(std::move(dict_tmp));
     }
 
-     return json::Builder{}.StartDict()
-                            .Key("request_id").Value(id.GetValue())
-                            .Key("total_time").Value(info.value().total_time)
-                            .Key("items").Value(std::move(rout_items))
-                            .EndDict().Build().AsMap();
+    rout_items.EndArray()
+        .Key("request_id").Value(id)
+        .Key("total_time").Value(info.value().total_time)
+        .EndDict().Build();
 
 }
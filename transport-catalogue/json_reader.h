@@ -8,12 +8,17 @@
 #include <string_view>
 #include <vector>
 #include <istream>
+#include <ostream>
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <optional>
 #include <unordered_map>
+#include <utility>
 #include "json.h"
 #include "json_builder.h"
+#include "json_writer.h"
+#include "json_schema.h"
 #include "geo.h"
 #include "transport_catalogue.h"
 #include "map_renderer.h"
@@ -24,83 +29,137 @@
 #include <iomanip>
 #include <iostream>
 
+// Элемент base_requests. Поля, которых нет в запросе, остаются пустыми.
+// Строки ссылаются на текст запроса (раскрытые escape-последовательности - на копии
+// в JsonReader) и действительны, пока жив прочитавший их JsonReader
 struct CommandDescription {
-        // Определяет, задана ли команда (поле command непустое)
-        explicit operator bool() const {
-            return !command.AsString().empty();
-        }
-
-        bool operator!() const {
-            return !operator bool();
-        }
+    std::string_view type;                      // Stop или Bus
+    std::string_view name;                      // Название остановки или маршрута
+    std::optional<double> latitude;             // Stop
+    std::optional<double> longitude;            // Stop
+    std::vector<geo::Distance> road_distances;  // Stop
+    std::vector<std::string_view> stops;        // Bus
+    bool is_roundtrip = false;                  // Bus
+};
 
-        json::Node command;      // Название команды
-        json::Node id;           // id маршрута или остановки
-        std::unordered_map<std::string, json::Node> description;  // Параметры команды
-    };
+// Элемент delta_requests: команда base_requests с действием над справочником
+// или расстояние между остановками (type Distance)
+struct DeltaDescription : CommandDescription {
+    std::string_view action;    // add, replace или remove
+    std::string_view from;      // Distance
+    std::string_view to;        // Distance
+    unsigned int distance = 0;  // Distance
+};
 
+// Элемент stat_requests
 struct RequestDescription {
-    // Определяет, задана ли команда (поле command непустое)
-    explicit operator bool() const {
-        return !type.AsString().empty();
-    }
-
-    bool operator!() const {
-        return !operator bool();
-    }
-
-    json::Node id;              // Уникальный числовой идентификатор запроса
-    json::Node type;           // Тип запроса
-    std::unordered_map<std::string, json::Node> description;//Параметры команды
+    int id = 0;                 // Уникальный числовой идентификатор запроса
+    std::string type;           // Bus, Stop, Map или Route
+    std::string name;           // Bus, Stop
+    std::string from;           // Route
+    std::string to;             // Route
 };
 
 class JsonReader {
 public:
 
     explicit JsonReader(std::istream& input_stream);
+    // Буфер должен жить, пока жив JsonReader: разделы разбираются из него по мере обращения
+    explicit JsonReader(std::string_view input);
 
+    // Ленивый режим: документ только размечается, а каждый раздел разбирается
+    // при первом обращении к нему (Apply*, Get*Description). Синтаксические ошибки
+    // внутри раздела выбрасываются тогда же. base_requests разбираются параллельно,
+    // если команд достаточно много
     void ReadAndParse();
 
-    void ApplyCommands([[maybe_unused]] catalogue::TransportCatalogue& catalogue) const;
-    json::Document ApplyRequest(const RequestHandler& handler);
+    // Если base_requests ещё не разобраны через GetCommandsDescription(), они читаются
+    // кусками прямо в пакет справочника, а их описания потом не хранятся
+    void ApplyCommands([[maybe_unused]] catalogue::TransportCatalogue& catalogue);
+    // Применяет delta_requests к замороженному справочнику, например загруженному из снимка.
+    // road_distances остановки задают расстояния от неё, как в base_requests.
+    // Без delta_requests справочник не меняется
+    void ApplyDelta(catalogue::TransportCatalogue& catalogue);
+    // Ответы на stat_requests выводятся в output по мере вычисления
+    void ApplyRequest(const RequestHandler& handler, std::ostream& output);
+    // Без запросов Map настройки отрисовки не разбираются, а renderer не меняется
     void ApplyRender(renderer::MapRenderer& renderer);
-    void ApplyRouter(routing::Settings& settings);
+    // Возвращает, есть ли запросы Route; без них настройки маршрутизации не разбираются,
+    // а settings не меняются, так что маршрутизатор можно не строить
+    bool ApplyRouter(routing::Settings& settings);
 
 
-    const std::vector<CommandDescription>& GetCommandsDescription(){
-        return commands_;
-    }
-    const std::vector<RequestDescription>& GetRequestsDescription(){
-        return request_;
-    }
+    const std::vector<CommandDescription>& GetCommandsDescription();
+    const std::vector<RequestDescription>& GetRequestsDescription();
+    const std::vector<DeltaDescription>& GetDeltaDescription();
+
+    //For commands
+    static geo::Coordinates ParseCoordinates(const CommandDescription& data);
+    // Добавляет команду в пакет для TransportCatalogue::Load(); JsonReader команды должен жить до Freeze()
+    static void AddToBulkData(const CommandDescription& command, catalogue::TransportCatalogue::BulkData& data);
+    // Неизвестное действие - std::invalid_argument; JsonReader команды должен жить до ApplyDelta()
+    static void AddToDeltaData(const DeltaDescription& command, catalogue::TransportCatalogue::DeltaData& data);
       
 private:
-    std::istream& input_stream_;
+    // Число команд каждого вида, подсчитанное при разборе: по нему ApplyCommands
+    // заранее резервирует память справочника
+    struct CommandCounts {
+        size_t stops = 0;
+        size_t buses = 0;
+    };
+
+    std::istream* input_stream_ = nullptr;
+    std::string_view input_;
+    // Прочитанный input_stream_: на него ссылаются отложенные разделы
+    std::string input_buffer_;
+    // Строки команд, на которые ссылаются CommandDescription и DeltaDescription
+    json::schema::StringStore strings_;
+
+    // Текст разделов, которые есть в документе, но ещё не разобраны
+    struct PendingSections {
+        std::optional<std::string_view> base_requests;
+        std::optional<std::string_view> render_settings;
+        std::optional<std::string_view> routing_settings;
+        std::optional<std::string_view> stat_requests;
+        std::optional<std::string_view> delta_requests;
+    };
+    PendingSections pending_;
 
     std::vector<CommandDescription> commands_;
+    CommandCounts command_counts_;
     std::vector<RequestDescription> request_;
+    std::vector<DeltaDescription> delta_;
     renderer::RenderSettings renderer_;
     routing::Settings routing_settings_;
 
     /*--------------------- Answer on requests ----------------------------*/
-    json::Dict GenerateBusInfo(const json::Node& id, const std::optional<catalogue::BusRoutInfo>& info);
-    json::Dict GenerateStopInfo(const json::Node& id, const std::optional<std::set<std::string_view>>& info);
-    json::Dict GenerateErrorMessege(const json::Node& id);
-    json::Dict GenerateMapInfo(const json::Node& id, const svg::Document& info);
-    json::Dict GenerateRouteInfo(const json::Node& id, std::optional<routing::RouteData> info);
+    void GenerateBusInfo(json::Writer& writer, int id, const std::optional<catalogue::BusRoutInfo>& info);
+    void GenerateStopInfo(json::Writer& writer, int id, const std::optional<std::set<std::string_view>>& info);
+    void GenerateErrorMessege(json::Writer& writer, int id);
+    void GenerateMapInfo(json::Writer& writer, int id, const svg::Document& info);
+    void GenerateRouteInfo(json::Writer& writer, int id, std::optional<routing::RouteData> info);
+    // Есть ли в stat_requests запросы вида type
+    bool HasRequests(std::string_view type);
 
 
     /*--------------------- Parser ----------------------------*/
-    std::vector<CommandDescription> ParseCommands(const json::Array& data);
-    std::vector<RequestDescription> ParseRequest(const json::Array& data);
-    renderer::RenderSettings ParseRender(const json::Dict& data);
-    routing::Settings ParseRouteSetting(const json::Dict& data);
-    
-    //For commands
-    geo::Coordinates ParseCoordinates(const CommandDescription& data) const;
-    std::vector<geo::Distance> ParseDistances(const CommandDescription& data) const;
-    catalogue::Bus ParseRoute(const CommandDescription& data, const catalogue::TransportCatalogue& catalogue) const;
-    
-    //For renderer
-    svg::Color ParseColor(json::Node data);
+    // Разделы читаются в типизированные структуры по таблицам полей из json_reader.cpp.
+    // Меньше стольких команд на поток параллельный разбор не окупается
+    static constexpr size_t MIN_COMMANDS_PER_WORKER = 256;
+    // ApplyCommands разбирает base_requests кусками по столько команд
+    static constexpr size_t COMMANDS_PER_CHUNK = 16 * 1024;
+    static CommandCounts ParseCommands(std::string_view text, std::vector<CommandDescription>& commands,
+                                       json::schema::StringStore& strings);
+    // Разбирает тексты команд в commands, параллельно, если их достаточно много
+    static CommandCounts ParseCommandChunk(const std::vector<std::string_view>& elements,
+                                           std::vector<CommandDescription>& commands,
+                                           json::schema::StringStore& strings);
+    // Разбирает отложенный раздел в target, если это ещё не сделано
+    template <typename T>
+    void ParsePending(std::optional<std::string_view>& text, T& target){
+        if(text){
+            json::schema::Parse(*std::exchange(text, std::nullopt), target, &strings_);
+        }
+    }
+
 };
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "json_scan.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define JSON_SCAN_SSE2
+#if defined(__GNUC__)
+#define JSON_SCAN_AVX2
+#endif
+#endif
+
+namespace json {
+namespace scan {
+
+namespace {
+
+const char* SkipWhitespaceScalar(const char* pos, const char* end) {
+    while (pos != end && IsSpace(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+const char* FindStringSpecialScalar(const char* pos, const char* end) {
+    while (pos != end && !IsStringSpecial(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+const char* FindStructuralScalar(const char* pos, const char* end) {
+    while (pos != end && !IsStructural(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+int CountTrailingZeros(uint32_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int count = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+#ifdef JSON_SCAN_SSE2
+
+// Маска байтов блока, являющихся пробельными символами: ' ' и '\t'...'\r'
+inline uint32_t SpaceMask16(__m128i block) {
+    const __m128i is_space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+    // '\t'...'\r' - это 9...13: после вычитания 9 беззнаковое сравнение с 4 через max
+    const __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    const __m128i is_control = _mm_cmpeq_epi8(_mm_max_epu8(shifted, _mm_set1_epi8(4)), _mm_set1_epi8(4));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(is_space, is_control)));
+}
+
+inline uint32_t StringSpecialMask16(__m128i block) {
+    const __m128i quote = _mm_cmpeq_epi8(block, _mm_set1_epi8('"'));
+    const __m128i backslash = _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'));
+    const __m128i new_line = _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'));
+    const __m128i carriage_return = _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'));
+    return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(quote, backslash), _mm_or_si128(new_line, carriage_return))));
+}
+
+// '[' и ']' отличаются от '{' и '}' только битом 0x20, поэтому хватает трёх сравнений
+inline uint32_t StructuralMask16(__m128i block) {
+    const __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+    const __m128i quote = _mm_cmpeq_epi8(block, _mm_set1_epi8('"'));
+    const __m128i open = _mm_cmpeq_epi8(lower, _mm_set1_epi8('{'));
+    const __m128i close = _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(quote, _mm_or_si128(open, close))));
+}
+
+const char* SkipWhitespaceSse2(const char* pos, const char* end) {
+    while (end - pos >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const uint32_t not_space = ~SpaceMask16(block) & 0xFFFF;
+        if (not_space != 0) {
+            return pos + CountTrailingZeros(not_space);
+        }
+        pos += 16;
+    }
+    return SkipWhitespaceScalar(pos, end);
+}
+
+const char* FindStringSpecialSse2(const char* pos, const char* end) {
+    while (end - pos >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        if (const uint32_t special = StringSpecialMask16(block); special != 0) {
+            return pos + CountTrailingZeros(special);
+        }
+        pos += 16;
+    }
+    return FindStringSpecialScalar(pos, end);
+}
+
+const char* FindStructuralSse2(const char* pos, const char* end) {
+    while (end - pos >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        if (const uint32_t structural = StructuralMask16(block); structural != 0) {
+            return pos + CountTrailingZeros(structural);
+        }
+        pos += 16;
+    }
+    return FindStructuralScalar(pos, end);
+}
+
+#endif  // JSON_SCAN_SSE2
+
+#ifdef JSON_SCAN_AVX2
+
+__attribute__((target("avx2")))
+const char* SkipWhitespaceAvx2(const char* pos, const char* end) {
+    while (end - pos >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i is_space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+        const __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+        const __m256i is_control = _mm256_cmpeq_epi8(_mm256_max_epu8(shifted, _mm256_set1_epi8(4)),
+                                                     _mm256_set1_epi8(4));
+        const uint32_t not_space = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_space, is_control)));
+        if (not_space != 0) {
+            return pos + CountTrailingZeros(not_space);
+        }
+        pos += 32;
+    }
+    return SkipWhitespaceSse2(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char* FindStringSpecialAvx2(const char* pos, const char* end) {
+    while (end - pos >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i quote = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"'));
+        const __m256i backslash = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'));
+        const __m256i new_line = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+        const __m256i carriage_return = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'));
+        const uint32_t special = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_or_si256(quote, backslash), _mm256_or_si256(new_line, carriage_return))));
+        if (special != 0) {
+            return pos + CountTrailingZeros(special);
+        }
+        pos += 32;
+    }
+    return FindStringSpecialSse2(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char* FindStructuralAvx2(const char* pos, const char* end) {
+    while (end - pos >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+        const __m256i quote = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"'));
+        const __m256i open = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{'));
+        const __m256i close = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'));
+        const uint32_t structural = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(quote, _mm256_or_si256(open, close))));
+        if (structural != 0) {
+            return pos + CountTrailingZeros(structural);
+        }
+        pos += 32;
+    }
+    return FindStructuralSse2(pos, end);
+}
+
+#endif  // JSON_SCAN_AVX2
+
+using ScanFunction = const char* (*)(const char*, const char*);
+
+struct ScanFunctions {
+    ScanFunction skip_whitespace;
+    ScanFunction find_string_special;
+    ScanFunction find_structural;
+};
+
+ScanFunctions SelectScanFunctions() {
+#ifdef JSON_SCAN_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return {SkipWhitespaceAvx2, FindStringSpecialAvx2, FindStructuralAvx2};
+    }
+#endif
+#ifdef JSON_SCAN_SSE2
+    return {SkipWhitespaceSse2, FindStringSpecialSse2, FindStructuralSse2};
+#else
+    return {SkipWhitespaceScalar, FindStringSpecialScalar, FindStructuralScalar};
+#endif
+}
+
+const ScanFunctions& GetScanFunctions() {
+    static const ScanFunctions functions = SelectScanFunctions();
+    return functions;
+}
+
+}  // namespace
+
+const char* SkipWhitespace(const char* pos, const char* end) {
+    // Между лексемами чаще всего нет пробелов или есть один, блочный поиск для них не нужен
+    if (pos == end || !IsSpace(*pos)) {
+        return pos;
+    }
+    ++pos;
+    if (pos == end || !IsSpace(*pos)) {
+        return pos;
+    }
+    return GetScanFunctions().skip_whitespace(pos, end);
+}
+
+const char* FindStringSpecial(const char* pos, const char* end) {
+    return GetScanFunctions().find_string_special(pos, end);
+}
+
+const char* FindStructural(const char* pos, const char* end) {
+    return GetScanFunctions().find_structural(pos, end);
+}
+
+}  // namespace scan
+}  // namespace json
@@ -0,0 +1,36 @@
+#pragma once
+
+/*
+ * Поиск символов разметки JSON блоками по 16-32 байта.
+ * На x86-64 используется SSE2, а при поддержке процессором - AVX2
+ * (выбор делается один раз во время выполнения), на остальных платформах - побайтовый проход
+ */
+
+namespace json {
+namespace scan {
+
+// Возвращает указатель на первый непробельный символ в [pos, end) или end
+const char* SkipWhitespace(const char* pos, const char* end);
+
+// Возвращает указатель на первый из символов '"', '\\', '\n', '\r' в [pos, end) или end.
+// Всё до него можно копировать в строку без обработки
+const char* FindStringSpecial(const char* pos, const char* end);
+
+// Возвращает указатель на первый из символов '"', '{', '}', '[', ']' в [pos, end) или end.
+// Нужен, чтобы пропускать значения, не разбирая их
+const char* FindStructural(const char* pos, const char* end);
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool IsStringSpecial(char c) {
+    return c == '"' || c == '\\' || c == '\n' || c == '\r';
+}
+
+inline bool IsStructural(char c) {
+    return c == '"' || c == '{' || c == '}' || c == '[' || c == ']';
+}
+
+}  // namespace scan
+}  // namespace json
@@ -0,0 +1,179 @@
+#include "json_schema.h"
+
+#include <cstdint>
+#include <utility>
+
+namespace json {
+namespace schema {
+
+std::string_view StringStore::Keep(std::string_view value) {
+    // Сравниваются адреса, а не содержимое: строка либо целиком лежит в тексте, либо вне его
+    const auto address = [](const char* p) {
+        return reinterpret_cast<std::uintptr_t>(p);
+    };
+    if (address(value.data()) >= address(input_.data())
+        && address(value.data() + value.size()) <= address(input_.data() + input_.size())) {
+        return value;
+    }
+    std::lock_guard lock(mutex_);
+    return copies_.emplace_back(value);
+}
+
+void Decoder::Reset(Target target) {
+    root_ = target;
+    done_ = false;
+    frames_.clear();
+    field_ = {};
+    skip_depth_ = 0;
+}
+
+void Decoder::StartDict() {
+    StartContainer(false);
+}
+
+void Decoder::Key(std::string_view key) {
+    if (skip_depth_ > 0) {
+        return;
+    }
+    Frame& frame = frames_.back();
+    if (frame.target.ops->keeps_views) {
+        key = Keep(key);
+    }
+    field_ = frame.target.ops->field(frame.target.object, key, frame.state);
+}
+
+void Decoder::EndDict() {
+    EndContainer();
+}
+
+void Decoder::StartArray() {
+    StartContainer(true);
+}
+
+void Decoder::EndArray() {
+    EndContainer();
+}
+
+void Decoder::Null() {
+    if (skip_depth_ > 0) {
+        return;
+    }
+    if (const Target target = NextTarget(); target.ops != nullptr) {
+        if (target.ops->set_null == nullptr) {
+            throw std::logic_error(target.ops->expected);
+        }
+        target.ops->set_null(target.object);
+    }
+    EndValue();
+}
+
+void Decoder::Bool(bool value) {
+    if (skip_depth_ > 0) {
+        return;
+    }
+    if (const Target target = NextTarget(); target.ops != nullptr) {
+        if (target.ops->set_bool == nullptr) {
+            throw std::logic_error(target.ops->expected);
+        }
+        target.ops->set_bool(target.object, value);
+    }
+    EndValue();
+}
+
+void Decoder::Int(int value) {
+    if (skip_depth_ > 0) {
+        return;
+    }
+    if (const Target target = NextTarget(); target.ops != nullptr) {
+        if (target.ops->set_int == nullptr) {
+            throw std::logic_error(target.ops->expected);
+        }
+        target.ops->set_int(target.object, value);
+    }
+    EndValue();
+}
+
+void Decoder::Double(double value) {
+    if (skip_depth_ > 0) {
+        return;
+    }
+    if (const Target target = NextTarget(); target.ops != nullptr) {
+        if (target.ops->set_double == nullptr) {
+            throw std::logic_error(target.ops->expected);
+        }
+        target.ops->set_double(target.object, value);
+    }
+    EndValue();
+}
+
+void Decoder::String(std::string_view value) {
+    if (skip_depth_ > 0) {
+        return;
+    }
+    if (const Target target = NextTarget(); target.ops != nullptr) {
+        if (target.ops->set_string == nullptr) {
+            throw std::logic_error(target.ops->expected);
+        }
+        target.ops->set_string(target.object, target.ops->keeps_views ? Keep(value) : value);
+    }
+    EndValue();
+}
+
+// Куда записать очередное значение: корень, элемент массива или поле последнего ключа
+Target Decoder::NextTarget() {
+    if (frames_.empty()) {
+        return root_;
+    }
+    Frame& frame = frames_.back();
+    if (frame.is_array) {
+        return frame.target.ops->element(frame.target.object, frame.state);
+    }
+    return std::exchange(field_, Target{});
+}
+
+void Decoder::StartContainer(bool is_array) {
+    if (skip_depth_ > 0) {
+        ++skip_depth_;
+        return;
+    }
+    const Target target = NextTarget();
+    if (target.ops == nullptr) {
+        skip_depth_ = 1;
+        return;
+    }
+    if (is_array ? target.ops->element == nullptr : target.ops->field == nullptr) {
+        throw std::logic_error(target.ops->expected);
+    }
+    frames_.push_back({target, is_array});
+}
+
+void Decoder::EndContainer() {
+    if (skip_depth_ > 0) {
+        if (--skip_depth_ == 0) {
+            EndValue();
+        }
+        return;
+    }
+    const Frame frame = frames_.back();
+    frames_.pop_back();
+    if (frame.target.ops->finish != nullptr) {
+        frame.target.ops->finish(frame.target.object, frame.state);
+    }
+    EndValue();
+}
+
+void Decoder::EndValue() {
+    if (frames_.empty()) {
+        done_ = true;
+    }
+}
+
+std::string_view Decoder::Keep(std::string_view value) {
+    if (strings_ == nullptr) {
+        throw std::logic_error("string_view field needs a StringStore");
+    }
+    return strings_->Keep(value);
+}
+
+}  // namespace schema
+}  // namespace json
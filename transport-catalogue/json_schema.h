@@ -0,0 +1,376 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+namespace schema {
+
+// Типизированное чтение JSON без дерева Node: события разбора сразу записываются
+// в поля структур. Поля структуры T перечисляет специализация Descriptor<T>,
+// по ней при компиляции строится таблица операций TypeOps.
+//
+//     template <>
+//     struct Descriptor<routing::Settings> {
+//         static constexpr auto fields = std::make_tuple(
+//             Required("bus_velocity", &routing::Settings::bus_velocity),
+//             Required("bus_wait_time", &routing::Settings::bus_wait_time));
+//     };
+//
+// Неизвестные ключи пропускаются без построения значений, повторный известный ключ - ParsingError.
+// Поля std::string_view ссылаются на строки разбираемого текста, поэтому читаются только
+// Decoder'ом со StringStore (см. ниже)
+
+struct TypeOps;
+
+// Значение, в которое записываются события. Без ops значение пропускается
+struct Target {
+    void* object = nullptr;
+    const TypeOps* ops = nullptr;
+};
+
+// Что можно записать в значение одного типа; nullptr - такой JSON для типа недопустим
+struct TypeOps {
+    // Текст исключения при несовпадении типа, как у Node::AsInt() и т.п.
+    const char* expected = "";
+    void (*set_null)(void* object) = nullptr;
+    void (*set_bool)(void* object, bool value) = nullptr;
+    void (*set_int)(void* object, int value) = nullptr;
+    void (*set_double)(void* object, double value) = nullptr;
+    void (*set_string)(void* object, std::string_view value) = nullptr;
+    // set_string или field сохраняют ссылку на строку, а не копию
+    bool keeps_views = false;
+    // Значение по ключу словаря; state - состояние словаря, у структур - маска прочитанных полей
+    Target (*field)(void* object, std::string_view key, uint64_t& state) = nullptr;
+    // Место под очередной элемент массива; state - число прочитанных элементов
+    Target (*element)(void* object, uint64_t& state) = nullptr;
+    // Вызывается в конце словаря или массива
+    void (*finish)(void* object, uint64_t state) = nullptr;
+};
+
+// Поле структуры: ключ JSON и указатель на член
+template <typename Class, typename Member>
+struct Field {
+    std::string_view name;
+    Member Class::* member;
+    bool required;
+};
+
+// Без такого поля Decoder выбрасывает std::out_of_range, как Dict::at()
+template <typename Class, typename Member>
+constexpr Field<Class, Member> Required(std::string_view name, Member Class::* member) {
+    return {name, member, true};
+}
+
+// Без такого поля член сохраняет прежнее значение
+template <typename Class, typename Member>
+constexpr Field<Class, Member> Optional(std::string_view name, Member Class::* member) {
+    return {name, member, false};
+}
+
+template <typename T>
+struct Descriptor;
+
+// Операции для типа T: static constexpr TypeOps ops.
+// Общий шаблон - структуры с Descriptor<T>; специализации можно добавлять для своих типов
+template <typename T, typename Enable = void>
+struct Ops;
+
+template <typename T>
+Target TargetOf(T& value) {
+    return {&value, &Ops<T>::ops};
+}
+
+template <typename T, typename Enable>
+struct Ops {
+    static constexpr auto& fields = Descriptor<T>::fields;
+    static_assert(std::tuple_size_v<std::decay_t<decltype(fields)>> <= 64, "too many fields");
+
+    static Target Field(void* object, std::string_view key, uint64_t& state) {
+        T& value = *static_cast<T*>(object);
+        Target target;
+        uint64_t bit = 1;
+        std::apply([&](const auto&... field) {
+            ((field.name == key ? (target = TargetOf(value.*field.member), true) : (bit <<= 1, false)) || ...);
+        }, fields);
+        if (target.ops != nullptr) {
+            // Как json::Load: повторный ключ не перезаписывает и не дополняет поле
+            if (state & bit) {
+                throw ParsingError("Duplicate key '" + std::string(key) + "' have been found");
+            }
+            state |= bit;
+        }
+        return target;
+    }
+    static void Finish(void*, uint64_t state) {
+        uint64_t bit = 1;
+        std::apply([&](const auto&... field) {
+            ((field.required && (state & bit) == 0 ? throw std::out_of_range("Missing key '" + std::string(field.name) + "'")
+                                                   : void(), bit <<= 1), ...);
+        }, fields);
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Map";
+        result.field = &Field;
+        result.finish = &Finish;
+        return result;
+    }();
+};
+
+template <typename T>
+struct Ops<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static void SetInt(void* object, int value) {
+        *static_cast<T*>(object) = static_cast<T>(value);
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Int";
+        result.set_int = &SetInt;
+        return result;
+    }();
+};
+
+template <>
+struct Ops<bool> {
+    static void SetBool(void* object, bool value) {
+        *static_cast<bool*>(object) = value;
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Bool";
+        result.set_bool = &SetBool;
+        return result;
+    }();
+};
+
+// Как Node::AsDouble(), принимает и целые числа
+template <>
+struct Ops<double> {
+    static void SetInt(void* object, int value) {
+        *static_cast<double*>(object) = value;
+    }
+    static void SetDouble(void* object, double value) {
+        *static_cast<double*>(object) = value;
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Double";
+        result.set_int = &SetInt;
+        result.set_double = &SetDouble;
+        return result;
+    }();
+};
+
+template <>
+struct Ops<std::string> {
+    static void SetString(void* object, std::string_view value) {
+        static_cast<std::string*>(object)->assign(value);
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not String";
+        result.set_string = &SetString;
+        return result;
+    }();
+};
+
+// Ссылка на строку из StringStore Decoder'а
+template <>
+struct Ops<std::string_view> {
+    static void SetString(void* object, std::string_view value) {
+        *static_cast<std::string_view*>(object) = value;
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not String";
+        result.set_string = &SetString;
+        result.keeps_views = true;
+        return result;
+    }();
+};
+
+template <typename T>
+struct Ops<std::vector<T>> {
+    static Target Element(void* object, uint64_t&) {
+        return TargetOf(static_cast<std::vector<T>*>(object)->emplace_back());
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Array";
+        result.element = &Element;
+        return result;
+    }();
+};
+
+// Лишние элементы пропускаются
+template <typename T, size_t N>
+struct Ops<std::array<T, N>> {
+    static Target Element(void* object, uint64_t& state) {
+        const uint64_t index = state++;
+        return index < N ? TargetOf((*static_cast<std::array<T, N>*>(object))[index]) : Target{};
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = "not Array";
+        result.element = &Element;
+        return result;
+    }();
+};
+
+// null сбрасывает значение; поддерживаются только скалярные T
+template <typename T>
+struct Ops<std::optional<T>> {
+    static constexpr const TypeOps& value_ops = Ops<T>::ops;
+
+    template <typename Value>
+    static void Set(void (*setter)(void*, Value), void* object, Value value) {
+        if (setter == nullptr) {
+            throw std::logic_error(value_ops.expected);
+        }
+        setter(&static_cast<std::optional<T>*>(object)->emplace(), value);
+    }
+    static void SetNull(void* object) {
+        static_cast<std::optional<T>*>(object)->reset();
+    }
+    static void SetBool(void* object, bool value) {
+        Set(value_ops.set_bool, object, value);
+    }
+    static void SetInt(void* object, int value) {
+        Set(value_ops.set_int, object, value);
+    }
+    static void SetDouble(void* object, double value) {
+        Set(value_ops.set_double, object, value);
+    }
+    static void SetString(void* object, std::string_view value) {
+        Set(value_ops.set_string, object, value);
+    }
+    static constexpr TypeOps ops = [] {
+        TypeOps result;
+        result.expected = value_ops.expected;
+        result.keeps_views = value_ops.keeps_views;
+        result.set_null = &SetNull;
+        result.set_bool = &SetBool;
+        result.set_int = &SetInt;
+        result.set_double = &SetDouble;
+        result.set_string = &SetString;
+        return result;
+    }();
+};
+
+// Строки, на которые ссылаются поля std::string_view. Строки без escape-последовательностей
+// лежат в разбираемом тексте и не копируются, раскрытые копируются сюда. Keep() можно
+// вызывать из нескольких потоков одновременно
+class StringStore {
+public:
+    StringStore() = default;
+    // Текст должен жить, пока живы ссылки на его строки
+    explicit StringStore(std::string_view input)
+        : input_(input) {
+    }
+    StringStore(const StringStore&) = delete;
+    StringStore& operator=(const StringStore&) = delete;
+
+    // Копии, сделанные для прежнего текста, остаются действительными
+    void SetInput(std::string_view input) {
+        input_ = input;
+    }
+    // Ссылка на value, действительная, пока живы текст и хранилище
+    std::string_view Keep(std::string_view value);
+
+private:
+    std::string_view input_;
+    std::mutex mutex_;
+    // deque не перемещает строки при добавлении
+    std::deque<std::string> copies_;
+};
+
+// Получатель событий Parse(), записывающий одно значение JSON в типизированный объект.
+// При несовпадении типа выбрасывает std::logic_error с текстом как у Node::AsX()
+class Decoder final : public Handler {
+public:
+    Decoder() = default;
+    template <typename T>
+    explicit Decoder(T& target, StringStore* strings = nullptr)
+        : strings_(strings) {
+        Reset(TargetOf(target));
+    }
+    // Без хранилища поля std::string_view не читаются: std::logic_error
+    explicit Decoder(StringStore* strings)
+        : strings_(strings) {
+    }
+
+    // Начинает чтение нового значения; с пустым target значение пропускается
+    void Reset(Target target);
+    template <typename T>
+    void Reset(T& target) {
+        Reset(TargetOf(target));
+    }
+    // Значение прочитано целиком
+    bool IsDone() const {
+        return done_;
+    }
+
+    void StartDict() override;
+    void Key(std::string_view key) override;
+    void EndDict() override;
+    void StartArray() override;
+    void EndArray() override;
+    void Null() override;
+    void Bool(bool value) override;
+    void Int(int value) override;
+    void Double(double value) override;
+    void String(std::string_view value) override;
+
+private:
+    struct Frame {
+        Target target;
+        bool is_array;
+        uint64_t state = 0;
+    };
+
+    StringStore* strings_ = nullptr;
+    Target root_;
+    bool done_ = false;
+    // Открытые словари и массивы, в конце - самый вложенный
+    std::vector<Frame> frames_;
+    // Значение для последнего ключа
+    Target field_;
+    // Глубина вложенности пропускаемого значения
+    int skip_depth_ = 0;
+
+    Target NextTarget();
+    void StartContainer(bool is_array);
+    void EndContainer();
+    void EndValue();
+    // Строка для значения, сохраняющего ссылку на неё
+    std::string_view Keep(std::string_view value);
+};
+
+// Разбирает текст JSON сразу в target
+template <typename T>
+void Parse(std::string_view input, T& target, StringStore* strings = nullptr) {
+    Decoder decoder(target, strings);
+    json::Parse(input, decoder);
+}
+
+// Записывает узел в target, как если бы он был разобран Decoder'ом
+template <typename T>
+void Decode(const Node& node, T& target) {
+    Decoder decoder(target);
+    Traverse(node, decoder);
+}
+
+}  // namespace schema
+}  // namespace json
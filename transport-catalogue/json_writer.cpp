@@ -0,0 +1,190 @@
+#include "json_writer.h"
+
+#include <charconv>
+#include <iterator>
+#include <stdexcept>
+
+namespace json {
+
+using namespace std::literals;
+
+namespace {
+
+// Буфер сбрасывается в поток, когда в нём накопилось столько байт
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+constexpr size_t INDENT_STEP = 4;
+
+}  // namespace
+
+Writer::Writer(std::ostream& output, Style style)
+    : output_(output)
+    , style_(style) {
+    buffer_.reserve(FLUSH_THRESHOLD + FLUSH_THRESHOLD / 4);
+}
+
+// Исключение из деструктора во время раскрутки стека завершило бы программу, поэтому
+// ошибки записи здесь не выпускаются наружу; их сообщает явный вызов Flush()
+Writer::~Writer() {
+    try {
+        Flush();
+    } catch (...) {
+    }
+}
+
+void Writer::StartDict() {
+    StartContainer('{', true);
+}
+
+void Writer::Key(std::string_view key) {
+    if (levels_.empty() || !levels_.back().is_dict || after_key_) {
+        throw std::logic_error("Key in wrong place");
+    }
+    BeginElement();
+    WriteString(key);
+    buffer_.append(style_ == Style::PRETTY ? ": "sv : ":"sv);
+    after_key_ = true;
+}
+
+void Writer::EndDict() {
+    EndContainer('}', true);
+}
+
+void Writer::StartArray() {
+    StartContainer('[', false);
+}
+
+void Writer::EndArray() {
+    EndContainer(']', false);
+}
+
+void Writer::Null() {
+    BeginValue();
+    buffer_.append("null"sv);
+    FlushIfFull();
+}
+
+void Writer::Bool(bool value) {
+    BeginValue();
+    buffer_.append(value ? "true"sv : "false"sv);
+    FlushIfFull();
+}
+
+void Writer::Int(int value) {
+    BeginValue();
+    char chars[16];
+    const auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    buffer_.append(chars, result.ptr);
+    FlushIfFull();
+}
+
+void Writer::Double(double value) {
+    BeginValue();
+    // Кратчайшая запись, из которой читается то же самое double; не зависит от локали
+    char chars[32];
+    const auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    buffer_.append(chars, result.ptr);
+    FlushIfFull();
+}
+
+void Writer::String(std::string_view value) {
+    BeginValue();
+    WriteString(value);
+    FlushIfFull();
+}
+
+void Writer::Value(const Node& node) {
+    Traverse(node, *this);
+}
+
+void Writer::Flush() {
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+// Значение в словаре пишется сразу после ключа, в массиве - как новый элемент
+void Writer::BeginValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (levels_.empty()) {
+        return;
+    }
+    if (levels_.back().is_dict) {
+        throw std::logic_error("Value without key");
+    }
+    BeginElement();
+}
+
+// Разделитель и отступ перед элементом массива или парой словаря
+void Writer::BeginElement() {
+    Level& level = levels_.back();
+    if (!level.is_empty) {
+        buffer_.append(style_ == Style::PRETTY ? ",\n"sv : ","sv);
+    }
+    level.is_empty = false;
+    if (style_ == Style::PRETTY) {
+        WriteIndent(levels_.size());
+    }
+}
+
+void Writer::StartContainer(char bracket, bool is_dict) {
+    BeginValue();
+    buffer_.push_back(bracket);
+    if (style_ == Style::PRETTY) {
+        buffer_.push_back('\n');
+    }
+    levels_.push_back({is_dict});
+}
+
+void Writer::EndContainer(char bracket, bool is_dict) {
+    if (levels_.empty() || levels_.back().is_dict != is_dict || after_key_) {
+        throw std::logic_error(is_dict ? "EndDict in wrong place" : "EndArray in wrong place");
+    }
+    levels_.pop_back();
+    if (style_ == Style::PRETTY) {
+        buffer_.push_back('\n');
+        WriteIndent(levels_.size());
+    }
+    buffer_.push_back(bracket);
+    FlushIfFull();
+}
+
+void Writer::WriteIndent(size_t depth) {
+    buffer_.append(depth * INDENT_STEP, ' ');
+}
+
+void Writer::WriteString(std::string_view value) {
+    buffer_.push_back('"');
+    for (const char c : value) {
+        switch (c) {
+            case '\r':
+                buffer_.append("\\r"sv);
+                break;
+            case '\n':
+                buffer_.append("\\n"sv);
+                break;
+            case '\t':
+                buffer_.append("\\t"sv);
+                break;
+            case '"':
+                // Символы " и \ выводятся как \" или \\, соответственно
+                [[fallthrough]];
+            case '\\':
+                buffer_.push_back('\\');
+                [[fallthrough]];
+            default:
+                buffer_.push_back(c);
+                break;
+        }
+    }
+    buffer_.push_back('"');
+}
+
+void Writer::FlushIfFull() {
+    if (buffer_.size() >= FLUSH_THRESHOLD) {
+        Flush();
+    }
+}
+
+}  // namespace json
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+
+// Потоковая запись JSON: значения сериализуются сразу, без построения дерева Node.
+// Текст копится во внутреннем буфере и сбрасывается в поток крупными блоками.
+// Методы совпадают с Handler, поэтому Writer может принимать события Parse()
+class Writer final : public Handler {
+public:
+    enum class Style {
+        // Тот же формат, что у Print(): отступ 4 пробела, каждый элемент с новой строки
+        PRETTY,
+        // Без пробелов и переводов строк
+        COMPACT
+    };
+
+    explicit Writer(std::ostream& output, Style style = Style::PRETTY);
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    ~Writer();
+
+    void StartDict() override;
+    // Ключи пишутся в порядке вызова; Print() выводит их отсортированными
+    void Key(std::string_view key) override;
+    void EndDict() override;
+    void StartArray() override;
+    void EndArray() override;
+    void Null() override;
+    void Bool(bool value) override;
+    void Int(int value) override;
+    void Double(double value) override;
+    void String(std::string_view value) override;
+
+    // Записывает узел целиком
+    void Value(const Node& node);
+
+    // Отдаёт накопленный текст в поток; ошибки потока с включёнными exceptions() выбрасываются.
+    // Деструктор тоже сбрасывает буфер, но ошибки глушит, поэтому в конце записи Flush()
+    // нужно вызвать явно
+    void Flush();
+
+private:
+    struct Level {
+        bool is_dict;
+        bool is_empty = true;
+    };
+
+    std::ostream& output_;
+    Style style_;
+    std::string buffer_;
+    // Открытые массивы и словари, в конце - самый вложенный
+    std::vector<Level> levels_;
+    // Ключ записан, ждём его значение
+    bool after_key_ = false;
+
+    void BeginValue();
+    void BeginElement();
+    void StartContainer(char bracket, bool is_dict);
+    void EndContainer(char bracket, bool is_dict);
+    void WriteIndent(size_t depth);
+    void WriteString(std::string_view value);
+    void FlushIfFull();
+};
+
+}  // namespace json
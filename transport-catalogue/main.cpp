@@ -1,28 +1,69 @@
+#include "input_buffer.h"
 #include "json_reader.h"
 #include "map_renderer.h"
 #include "transport_router.h"
 #include "request_handler.h"
+#include "snapshot.h"
+
+#include <fstream>
+#include <optional>
+#include <string_view>
 
 using namespace std;
 
-int main() {
+namespace {
+
+void PrintUsage(string_view program) {
+    cerr << "Usage: " << program << " [--snapshot FILE] [--save-snapshot FILE] < requests.json\n"
+         << "  --snapshot FILE       load the catalogue from a snapshot, base_requests are ignored\n"
+         << "  --save-snapshot FILE  save the catalogue after base_requests and delta_requests to a snapshot\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    string load_snapshot;
+    string save_snapshot;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if ((arg == "--snapshot" || arg == "--save-snapshot") && i + 1 < argc) {
+            (arg == "--snapshot" ? load_snapshot : save_snapshot) = argv[++i];
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
     catalogue::TransportCatalogue catalogue;
     renderer::MapRenderer renderer;
     RequestHandler handler(catalogue, renderer);
 
     {
-        JsonReader reader(std::cin);
+        const InputBuffer input = InputBuffer::FromStdin();
+        JsonReader reader(input.GetData());
         reader.ReadAndParse();
-        reader.ApplyCommands(catalogue);
+        if (!load_snapshot.empty()) {
+            // Разделы разбираются при первом обращении, так что base_requests даже не читаются
+            catalogue = catalogue::LoadSnapshot(load_snapshot);
+        } else {
+            reader.ApplyCommands(catalogue);
+        }
+        reader.ApplyDelta(catalogue);
+        if (!save_snapshot.empty()) {
+            ofstream output(save_snapshot, ios::binary);
+            catalogue::WriteSnapshot(catalogue, output);
+        }
         reader.ApplyRender(renderer);
 
+        // Граф маршрутизатора строится по всем парам остановок маршрутов, поэтому только для запросов Route.
+        // Копия в handler ссылается на граф router, так что он должен жить до ответов
         routing::Settings rout_settings;
-        reader.ApplyRouter(rout_settings);
+        optional<routing::TransportRouter> router;
+        if (reader.ApplyRouter(rout_settings)) {
+            router.emplace(catalogue, rout_settings);
+            handler.SetRouter(*router);
+        }
 
-        routing::TransportRouter router(catalogue, rout_settings);
-        handler.SetRouter(router);
-        
-        const auto answer = reader.ApplyRequest(handler);
-        Print(answer, std::cout);
+        reader.ApplyRequest(handler, std::cout);
     }
-}
\ No newline at end of file
+}
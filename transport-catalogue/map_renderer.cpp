@@ -33,8 +33,8 @@ svg::Document MapRenderer::GenerateMap(const catalogue::TransportCatalogue& cata
     return doc;
 }
 //SphereProjector
-MapProjectorForBusesStops MapRenderer::GenerateMapProjector(const std::unordered_map<std::string_view, const catalogue::Bus*>& data){
-    std::vector<const geo::Coordinates*> all_coordinates;
+MapProjectorForBusesStops MapRenderer::GenerateMapProjector(const catalogue::TransportCatalogue::BusIndex& data){
+    std::vector<const geo::StoredCoordinates*> all_coordinates;
     std::set<std::string_view> buses_names;
         
     //container from all coordinates
@@ -54,13 +54,13 @@ MapProjectorForBusesStops MapRenderer::GenerateMapProjector(const std::unordered
 }
 
 void MapRenderer::AddBusesPolyline(svg::Document& doc, SphereProjector proj, const std::set<std::string_view> buses_names,
-                                 const std::unordered_map<std::string_view, const catalogue::Bus*>& data){
+                                 const catalogue::TransportCatalogue::BusIndex& data){
 
         //Generation of polylines
         auto color_it = setting_.color_palette.begin();
         for(const auto& name:buses_names){
             svg::Polyline polyline;
-            for(const auto& stop:data.at(name)->stops){
+            for(const auto& stop:data.at(name)->GetRoute()){
                 const svg::Point point = proj(stop->coord);
                 polyline.AddPoint(point);
             }
@@ -79,7 +79,7 @@ void MapRenderer::AddBusesPolyline(svg::Document& doc, SphereProjector proj, con
     }
 
 void MapRenderer::AddBusesNames(svg::Document& doc, const SphereProjector& proj, const std::set<std::string_view> buses_names,
-                                    const std::unordered_map<std::string_view, const catalogue::Bus*>& data){
+                                    const catalogue::TransportCatalogue::BusIndex& data){
     auto color_it = setting_.color_palette.begin();
     
     for(const auto& bus_name:buses_names){    
@@ -92,8 +92,7 @@ void MapRenderer::AddBusesNames(svg::Document& doc, const SphereProjector& proj,
         
         if(data.at(bus_name)->is_roundtrip == false){
             
-            size_t numb = data.at(bus_name)->stops.size()/2;
-            const auto& last_stop = data.at(bus_name)->stops.at(numb);
+            const auto& last_stop = data.at(bus_name)->stops.back();
             if(last_stop->name == first_stop->name){
                 if (++color_it == setting_.color_palette.end()) {
                     color_it = setting_.color_palette.begin();
@@ -144,8 +143,8 @@ std::array<svg::Text,2> MapRenderer::MakeNameOfBus(std::string_view name,svg::Po
 }
 
 std::set<std::string_view> MapRenderer::AddStopsCircle(svg::Document& doc, const SphereProjector& proj,
-                const std::unordered_map<std::string_view, const catalogue::Stop*>& stops,
-                const std::unordered_map<std::string_view, std::set<std::string_view>>& buses_on_stop){
+                const catalogue::TransportCatalogue::StopIndex& stops,
+                const catalogue::TransportCatalogue::BusesOnStops& buses_on_stop){
     
     std::set<std::string_view> stops_names;
     for(const auto& [stop,buses]:buses_on_stop){
@@ -163,7 +162,7 @@ std::set<std::string_view> MapRenderer::AddStopsCircle(svg::Document& doc, const
 }
 
 void MapRenderer::AddStopsNames(svg::Document& doc, const SphereProjector& proj, const std::set<std::string_view> stops_names,
-                const std::unordered_map<std::string_view, const catalogue::Stop*>& stops_info){
+                const catalogue::TransportCatalogue::StopIndex& stops_info){
     
     for(const auto& stop:stops_names){
         svg::Text svg_name_of_stop;
@@ -27,7 +27,8 @@ bool IsZero(double value);
 
 class SphereProjector {
 public:
-    // points_begin и points_end задают начало и конец интервала элементов geo::Coordinates
+    // points_begin и points_end задают начало и конец интервала указателей на
+    // geo::Coordinates или geo::FixedCoordinates
     template <typename PointInputIt>
     SphereProjector(const PointInputIt points_begin, const PointInputIt points_end,
                     double max_width, double max_height, double padding)
@@ -42,15 +43,15 @@ public:
         const auto [left_it, right_it] = std::minmax_element(
             points_begin, points_end,
             [](auto lhs, auto rhs) { return lhs->lng < rhs->lng; });
-        min_lon_ = (*left_it)->lng;
-        const double max_lon = (*right_it)->lng;
+        min_lon_ = geo::ToCoordinates(**left_it).lng;
+        const double max_lon = geo::ToCoordinates(**right_it).lng;
 
         // Находим точки с минимальной и максимальной широтой
         const auto [bottom_it, top_it] = std::minmax_element(
             points_begin, points_end,
             [](auto lhs, auto rhs) { return lhs->lat < rhs->lat; });
-        const double min_lat = (*bottom_it)->lat;
-        max_lat_ = (*top_it)->lat;
+        const double min_lat = geo::ToCoordinates(**bottom_it).lat;
+        max_lat_ = geo::ToCoordinates(**top_it).lat;
 
         // Вычисляем коэффициент масштабирования вдоль координаты x
         std::optional<double> width_zoom;
@@ -84,6 +85,9 @@ public:
             (max_lat_ - coords.lat) * zoom_coeff_ + padding_
         };
     }
+    svg::Point operator()(geo::FixedCoordinates coords) const {
+        return (*this)(geo::ToCoordinates(coords));
+    }
 
 private:
     double padding_;
@@ -130,20 +134,20 @@ private:
 
     RenderSettings setting_;
 
-    MapProjectorForBusesStops GenerateMapProjector(const std::unordered_map<std::string_view, const catalogue::Bus*>& data);
+    MapProjectorForBusesStops GenerateMapProjector(const catalogue::TransportCatalogue::BusIndex& data);
 
     void AddBusesPolyline(svg::Document& doc, SphereProjector proj, const std::set<std::string_view> buses_names,
-                                    const std::unordered_map<std::string_view, const catalogue::Bus*>& data);
+                                    const catalogue::TransportCatalogue::BusIndex& data);
 
     void AddBusesNames(svg::Document& doc, const SphereProjector& proj, const std::set<std::string_view> buses_names,
-                    const std::unordered_map<std::string_view,const catalogue::Bus*>& data);
+                    const catalogue::TransportCatalogue::BusIndex& data);
  
     std::set<std::string_view> AddStopsCircle(svg::Document& doc, const SphereProjector& proj,
-                    const std::unordered_map<std::string_view, const catalogue::Stop*>& stops,
-                    const std::unordered_map<std::string_view, std::set<std::string_view>>& buses_on_stop);
+                    const catalogue::TransportCatalogue::StopIndex& stops,
+                    const catalogue::TransportCatalogue::BusesOnStops& buses_on_stop);
 
     void AddStopsNames(svg::Document& doc, const SphereProjector& proj, const std::set<std::string_view> stops_names,
-                    const std::unordered_map<std::string_view, const catalogue::Stop*>& stops_info);
+                    const catalogue::TransportCatalogue::StopIndex& stops_info);
 
     std::array<svg::Text,2> MakeNameOfBus(std::string_view name,svg::Point& position, svg::Color& color);
     std::array<svg::Text,2> MakeNameOfStop(std::string_view name, const svg::Point& position);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+inline size_t MaxWorkers() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Вызывает func(begin, end) для непрерывных кусков [0, count), каждый не короче min_chunk,
+// в нескольких потоках. Первый кусок обрабатывается в текущем потоке. Если куски выбросили
+// исключения, наружу уходит исключение самого раннего из них
+template <typename Func>
+void For(size_t count, size_t min_chunk, Func func) {
+    if (count == 0) {
+        return;
+    }
+    const size_t workers = std::clamp<size_t>(count / std::max<size_t>(min_chunk, 1), 1, MaxWorkers());
+    const size_t chunk_size = (count + workers - 1) / workers;
+
+    std::vector<std::future<void>> chunks;
+    for (size_t begin = chunk_size; begin < count; begin += chunk_size) {
+        chunks.push_back(std::async(std::launch::async, func, begin, std::min(begin + chunk_size, count)));
+    }
+    func(0, std::min(chunk_size, count));
+    for (auto& chunk : chunks) {
+        chunk.get();
+    }
+}
+
+// Выполняет независимые задачи одновременно; first - в текущем потоке.
+// Исключения выбрасываются в порядке задач
+template <typename First, typename... Rest>
+void Invoke(First first, Rest... rest) {
+    if (MaxWorkers() == 1) {
+        first();
+        (rest(), ...);
+        return;
+    }
+    std::array<std::future<void>, sizeof...(Rest)> tasks{std::async(std::launch::async, rest)...};
+    first();
+    for (auto& task : tasks) {
+        task.get();
+    }
+}
+
+}  // namespace parallel
@@ -0,0 +1,154 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace catalogue {
+
+namespace {
+
+constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+// Средний размер корзины: чем он больше, тем компактнее смещения и дольше построение
+constexpr size_t KEYS_PER_BUCKET = 4;
+// Сколько смещений пробовать для корзины, прежде чем начать заново с другим seed
+constexpr uint32_t MAX_DISPLACEMENT = 1u << 16;
+constexpr int MAX_ATTEMPTS = 32;
+
+// Финализатор splitmix64
+uint64_t Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Байты читаются как little-endian на любой платформе
+uint64_t LoadLittleEndian(const char* data, size_t count) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+size_t SlotOf(uint64_t hash, uint32_t displacement, size_t size) {
+    return static_cast<size_t>(Mix(hash + displacement * GOLDEN_GAMMA) % size);
+}
+
+}  // namespace
+
+PerfectHash::PerfectHash(const std::vector<std::string_view>& keys)
+    : size_(keys.size()) {
+    if (size_ >= DIRECT_SLOT) {
+        throw std::length_error("Too many keys for PerfectHash");
+    }
+    uint64_t seed = GOLDEN_GAMMA;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt, seed = Mix(seed)) {
+        seed_ = seed;
+        if (TryBuild(keys)) {
+            return;
+        }
+    }
+    // Одинаковые ключи не разделить никаким seed
+    throw std::invalid_argument("PerfectHash keys must be unique");
+}
+
+PerfectHash::PerfectHash(size_t size, uint64_t seed, std::vector<uint32_t> displacements)
+    : size_(size)
+    , seed_(seed)
+    , displacements_(std::move(displacements)) {
+}
+
+size_t PerfectHash::Slot(std::string_view key, size_t size, uint64_t seed,
+                         const uint32_t* displacements, size_t bucket_count) {
+    if (size == 0) {
+        return 0;
+    }
+    const uint64_t hash = Hash(key, seed);
+    const uint32_t displacement = displacements[hash % bucket_count];
+    if (displacement & DIRECT_SLOT) {
+        return displacement & ~DIRECT_SLOT;
+    }
+    return SlotOf(hash, displacement, size);
+}
+
+uint64_t PerfectHash::Hash(std::string_view key, uint64_t seed) {
+    uint64_t hash = seed ^ Mix(key.size() + GOLDEN_GAMMA);
+    size_t pos = 0;
+    for (; pos + 8 <= key.size(); pos += 8) {
+        hash = Mix(hash ^ LoadLittleEndian(key.data() + pos, 8));
+    }
+    return Mix(hash ^ LoadLittleEndian(key.data() + pos, key.size() - pos));
+}
+
+// Корзины размещаются от больших к маленьким: для каждой подбирается смещение, при котором
+// все её ключи попадают в свободные номера. Корзины из одного ключа занимают оставшиеся номера
+bool PerfectHash::TryBuild(const std::vector<std::string_view>& keys) {
+    const size_t bucket_count = std::max<size_t>(1, (size_ + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET);
+    std::vector<uint64_t> hashes(size_);
+    std::vector<size_t> offsets(bucket_count + 1, 0);
+    for (size_t i = 0; i < size_; ++i) {
+        hashes[i] = Hash(keys[i], seed_);
+        ++offsets[hashes[i] % bucket_count + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<size_t> bucket_keys(size_);
+    {
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < size_; ++i) {
+            bucket_keys[next[hashes[i] % bucket_count]++] = i;
+        }
+    }
+    const auto bucket_size = [&offsets](size_t bucket) {
+        return offsets[bucket + 1] - offsets[bucket];
+    };
+    std::vector<size_t> buckets(bucket_count);
+    std::iota(buckets.begin(), buckets.end(), 0);
+    std::stable_sort(buckets.begin(), buckets.end(), [&bucket_size](size_t lhs, size_t rhs) {
+        return bucket_size(lhs) > bucket_size(rhs);
+    });
+
+    displacements_.assign(bucket_count, 0);
+    std::vector<bool> taken(size_, false);
+    std::vector<size_t> slots;
+    auto bucket = buckets.begin();
+    for (; bucket != buckets.end() && bucket_size(*bucket) > 1; ++bucket) {
+        bool placed = false;
+        for (uint32_t displacement = 0; displacement < MAX_DISPLACEMENT && !placed; ++displacement) {
+            slots.clear();
+            placed = true;
+            for (size_t i = offsets[*bucket]; i < offsets[*bucket + 1]; ++i) {
+                const size_t slot = SlotOf(hashes[bucket_keys[i]], displacement, size_);
+                if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if (placed) {
+                displacements_[*bucket] = displacement;
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+        for (const size_t slot : slots) {
+            taken[slot] = true;
+        }
+    }
+
+    size_t free_slot = 0;
+    for (; bucket != buckets.end() && bucket_size(*bucket) == 1; ++bucket) {
+        while (taken[free_slot]) {
+            ++free_slot;
+        }
+        taken[free_slot] = true;
+        displacements_[*bucket] = DIRECT_SLOT | static_cast<uint32_t>(free_slot);
+    }
+    return true;
+}
+
+}  // namespace catalogue
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace catalogue {
+
+// Минимальная совершенная хеш-функция над неизменным набором различных строк
+// (CHD: hash, displace and compress): каждая из n строк набора получает свой номер из [0, n).
+// Строке не из набора тоже достаётся какой-то номер из [0, n), поэтому значение,
+// хранимое по номеру, нужно сверить с ключом одним сравнением строк.
+// Функция целиком задаётся seed и массивом смещений (4 байта на 4 ключа) и не зависит
+// от платформы, так что её можно сохранить в файл и восстановить
+class PerfectHash {
+public:
+    // Признак смещения, задающего номер ключа корзины из одного ключа напрямую
+    static constexpr uint32_t DIRECT_SLOT = 0x80000000u;
+
+    PerfectHash() = default;
+    explicit PerfectHash(const std::vector<std::string_view>& keys);
+    // Восстанавливает функцию, построенную ранее. Прямые номера в смещениях должны быть меньше size
+    PerfectHash(size_t size, uint64_t seed, std::vector<uint32_t> displacements);
+
+    size_t operator()(std::string_view key) const {
+        return Slot(key, size_, seed_, displacements_.data(), displacements_.size());
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+    uint64_t GetSeed() const {
+        return seed_;
+    }
+    const std::vector<uint32_t>& GetDisplacements() const {
+        return displacements_;
+    }
+
+    // Номер ключа по сохранённому представлению функции, без копирования смещений
+    static size_t Slot(std::string_view key, size_t size, uint64_t seed,
+                       const uint32_t* displacements, size_t bucket_count);
+
+    // Хеш, одинаковый на всех платформах
+    static uint64_t Hash(std::string_view key, uint64_t seed);
+
+private:
+    size_t size_ = 0;
+    uint64_t seed_ = 0;
+    // Индекс - корзина; с DIRECT_SLOT - номер ключа напрямую, иначе смещение для перехеширования
+    std::vector<uint32_t> displacements_;
+
+    bool TryBuild(const std::vector<std::string_view>& keys);
+};
+
+}  // namespace catalogue
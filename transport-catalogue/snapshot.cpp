@@ -0,0 +1,419 @@
+#include "snapshot.h"
+#include "input_buffer.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace catalogue {
+
+namespace {
+
+constexpr std::string_view SNAPSHOT_MAGIC = "TCATSNAP";
+
+class SnapshotWriter {
+public:
+    void U8(uint8_t value) {
+        data_.push_back(static_cast<char>(value));
+    }
+    void U32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            U8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+    void U64(uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            U8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+    void F64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        U64(bits);
+    }
+    void Size(size_t value) {
+        if (value > UINT32_MAX) {
+            throw std::length_error("Catalogue is too large for a snapshot");
+        }
+        U32(static_cast<uint32_t>(value));
+    }
+    void Bytes(std::string_view bytes) {
+        data_.append(bytes);
+    }
+
+    const std::string& GetData() const {
+        return data_;
+    }
+
+private:
+    std::string data_;
+};
+
+// Любой выход за границы файла или ссылка на несуществующую запись - std::runtime_error
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::string_view data)
+        : data_(data) {
+    }
+
+    uint8_t U8() {
+        return static_cast<uint8_t>(Bytes(1)[0]);
+    }
+    uint32_t U32() {
+        return static_cast<uint32_t>(LoadLittleEndian(Bytes(4)));
+    }
+    uint64_t U64() {
+        return LoadLittleEndian(Bytes(8));
+    }
+    double F64() {
+        const uint64_t bits = U64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    bool Bool() {
+        const uint8_t value = U8();
+        Check(value <= 1);
+        return value == 1;
+    }
+    // Номер записи из [0, limit)
+    uint32_t Index(size_t limit) {
+        const uint32_t value = U32();
+        Check(value < limit);
+        return value;
+    }
+    // Количество записей, каждая из которых занимает не меньше min_record_size байт.
+    // Проверка до выделения памяти: испорченный счётчик не приводит к огромному resize
+    uint32_t Count(size_t min_record_size) {
+        const uint32_t value = U32();
+        Check(static_cast<uint64_t>(value) * min_record_size <= data_.size() - pos_);
+        return value;
+    }
+    std::string_view Bytes(size_t count) {
+        Check(count <= data_.size() - pos_);
+        const std::string_view bytes = data_.substr(pos_, count);
+        pos_ += count;
+        return bytes;
+    }
+
+    bool AtEnd() const {
+        return pos_ == data_.size();
+    }
+
+    static void Check(bool condition) {
+        if (!condition) {
+            throw std::runtime_error("Invalid snapshot");
+        }
+    }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+
+    static uint64_t LoadLittleEndian(std::string_view bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+        }
+        return value;
+    }
+};
+
+void WriteHash(SnapshotWriter& writer, const PerfectHash& hash) {
+    writer.Size(hash.GetSize());
+    writer.U64(hash.GetSeed());
+    writer.Size(hash.GetDisplacements().size());
+    for (const uint32_t displacement : hash.GetDisplacements()) {
+        writer.U32(displacement);
+    }
+}
+
+PerfectHash ReadHash(SnapshotReader& reader, size_t expected_size) {
+    const uint32_t size = reader.U32();
+    SnapshotReader::Check(size == expected_size);
+    const uint64_t seed = reader.U64();
+    std::vector<uint32_t> displacements(reader.Count(4));
+    SnapshotReader::Check(size == 0 || !displacements.empty());
+    for (uint32_t& displacement : displacements) {
+        displacement = reader.U32();
+        // Прямой номер вне [0, size) увёл бы поиск за границы таблицы записей
+        SnapshotReader::Check((displacement & PerfectHash::DIRECT_SLOT) == 0
+                              || (displacement & ~PerfectHash::DIRECT_SLOT) < size);
+    }
+    return PerfectHash(size, seed, std::move(displacements));
+}
+
+// Индекс имён заново: после ApplyDelta() совершенный хеш справочника покрывает не все имена
+template <typename Entity>
+void WriteNameIndex(SnapshotWriter& writer, const TransportCatalogue::NameIndex<const Entity*>& entities) {
+    std::vector<std::string_view> names;
+    names.reserve(entities.size());
+    for (const auto& [name, entity] : entities) {
+        names.push_back(name);
+    }
+    const PerfectHash hash(names);
+    std::vector<uint32_t> ids(names.size());
+    for (const auto& [name, entity] : entities) {
+        ids[hash(name)] = entity->id;
+    }
+    WriteHash(writer, hash);
+    for (const uint32_t id : ids) {
+        writer.U32(id);
+    }
+}
+
+// Запись попадает в индексы, если её имя действует и не принадлежит более ранней записи:
+// удалённые через ApplyDelta() остаются в файле только ради сохранения id
+template <typename Entity>
+bool IsPresent(const TransportCatalogue::NameIndex<const Entity*>& entities, const Entity& entity) {
+    const auto it = entities.find(entity.name);
+    return it != entities.end() && it->second->id >= entity.id;
+}
+
+}  // namespace
+
+void WriteSnapshot(const TransportCatalogue& catalogue, std::ostream& output) {
+    if (!catalogue.IsFrozen()) {
+        throw std::logic_error("Only a frozen catalogue can be written to a snapshot");
+    }
+    const StringInterner& names = catalogue.names_;
+    const auto symbol = [&names](std::string_view name) {
+        return names.Find(name).value().id;
+    };
+
+    SnapshotWriter writer;
+    writer.Bytes(SNAPSHOT_MAGIC);
+    writer.U32(SNAPSHOT_VERSION);
+    writer.U32(0);
+
+    writer.Size(names.GetSize());
+    for (uint32_t id = 0; id < names.GetSize(); ++id) {
+        writer.Size(names.GetString({id}).size());
+    }
+    for (uint32_t id = 0; id < names.GetSize(); ++id) {
+        writer.Bytes(names.GetString({id}));
+    }
+
+    writer.Size(catalogue.stops_.size());
+    for (const Stop& stop : catalogue.stops_) {
+        const geo::Coordinates coord = geo::ToCoordinates(stop.coord);
+        writer.U32(symbol(stop.name));
+        writer.U8(IsPresent(catalogue.stop_ptrs_, stop));
+        writer.F64(coord.lat);
+        writer.F64(coord.lng);
+    }
+    for (const auto& adjacent : catalogue.road_distances_) {
+        writer.Size(adjacent.size());
+        for (const auto& distance : adjacent) {
+            writer.U32(distance.to);
+            writer.U32(distance.dist);
+            writer.U8(distance.is_direct);
+        }
+    }
+
+    writer.Size(catalogue.buses_.size());
+    for (const Bus& bus : catalogue.buses_) {
+        writer.U32(symbol(bus.name));
+        writer.U8(IsPresent(catalogue.bus_ptrs_, bus));
+        writer.U8(bus.is_roundtrip);
+        writer.Size(bus.stops.size());
+        for (const Stop* stop : bus.stops) {
+            writer.U32(stop->id);
+        }
+        const auto& lengths = catalogue.bus_lengths_[bus.id];
+        writer.U32(lengths.info.count_stops);
+        writer.U32(lengths.info.count_uniq_stops);
+        writer.U32(lengths.info.lenght);
+        writer.F64(lengths.info.curvature);
+        writer.Size(lengths.road.size());
+        for (const unsigned int road : lengths.road) {
+            writer.U32(road);
+        }
+        for (const double geo : lengths.geo) {
+            writer.F64(geo);
+        }
+    }
+
+    // Множества - в порядке первого появления имени среди остановок, как их создаёт Freeze
+    writer.Size(catalogue.buses_on_stop_.size());
+    std::unordered_set<std::string_view> written;
+    written.reserve(catalogue.buses_on_stop_.size());
+    for (const Stop& stop : catalogue.stops_) {
+        if (!IsPresent(catalogue.stop_ptrs_, stop) || !written.insert(stop.name).second) {
+            continue;
+        }
+        const auto& buses = catalogue.buses_on_stop_.at(stop.name);
+        writer.U32(symbol(stop.name));
+        writer.Size(buses.size());
+        for (const std::string_view bus : buses) {
+            writer.U32(symbol(bus));
+        }
+    }
+
+    if (catalogue.name_index_partial_) {
+        WriteNameIndex(writer, catalogue.stop_ptrs_);
+        WriteNameIndex(writer, catalogue.bus_ptrs_);
+    } else {
+        WriteHash(writer, catalogue.stop_hash_);
+        for (const auto& slot : catalogue.stop_slots_) {
+            writer.U32(slot.stop->id);
+        }
+        WriteHash(writer, catalogue.bus_hash_);
+        for (const auto& slot : catalogue.bus_slots_) {
+            writer.U32(slot.bus->id);
+        }
+    }
+
+    output.write(writer.GetData().data(), static_cast<std::streamsize>(writer.GetData().size()));
+    if (!output) {
+        throw std::runtime_error("Can't write snapshot");
+    }
+}
+
+// Записи восстанавливаются в порядке номеров, а хеш-таблицы резервируются так же, как во Freeze,
+// поэтому и порядок обхода GetAll* совпадает со справочником, с которого снят снимок
+TransportCatalogue LoadSnapshot(const std::string& path) {
+    const auto file = std::make_shared<const InputBuffer>(InputBuffer::FromFile(path));
+    SnapshotReader reader(file->GetData());
+    SnapshotReader::Check(reader.Bytes(SNAPSHOT_MAGIC.size()) == SNAPSHOT_MAGIC);
+    if (reader.U32() != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+    SnapshotReader::Check(reader.U32() == 0);
+
+    TransportCatalogue catalogue;
+
+    std::vector<std::string_view> names(reader.Count(4));
+    {
+        std::vector<uint32_t> lengths(names.size());
+        for (uint32_t& length : lengths) {
+            length = reader.U32();
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            names[i] = reader.Bytes(lengths[i]);
+        }
+    }
+    catalogue.names_.AddExternal(names, file);
+    // Символы должны совпасть с номерами имён в файле
+    SnapshotReader::Check(catalogue.names_.GetSize() == names.size());
+    const auto name = [&](uint32_t id) {
+        return names[id];
+    };
+
+    const size_t stop_count = reader.Count(4 + 1 + 8 + 8);
+    catalogue.stops_.resize(stop_count);
+    catalogue.prepared_coords_.Resize(stop_count);
+    std::vector<bool> present_stops(stop_count);
+    for (size_t i = 0; i < stop_count; ++i) {
+        Stop& stop = catalogue.stops_[i];
+        stop.name = name(reader.Index(names.size()));
+        present_stops[i] = reader.Bool();
+        const double lat = reader.F64();
+        const double lng = reader.F64();
+        stop.coord = geo::ToStoredCoordinates({lat, lng});
+        stop.id = static_cast<uint32_t>(i);
+        catalogue.prepared_coords_.Set(i, geo::Prepare(geo::ToCoordinates(stop.coord)));
+    }
+    catalogue.road_distances_.reserve(stop_count);
+    for (size_t i = 0; i < stop_count; ++i) {
+        auto& adjacent = catalogue.road_distances_.emplace_back(reader.Count(4 + 4 + 1), catalogue.GetAllocator<TransportCatalogue::RoadDistance>());
+        for (auto& distance : adjacent) {
+            distance.to = reader.Index(stop_count);
+            distance.dist = reader.U32();
+            distance.is_direct = reader.Bool();
+        }
+    }
+    catalogue.stop_ptrs_.reserve(stop_count);
+    for (const Stop& stop : catalogue.stops_) {
+        if (present_stops[stop.id]) {
+            catalogue.stop_ptrs_[stop.name] = &stop;
+        }
+    }
+
+    const size_t bus_count = reader.Count(4 + 1 + 1 + 4 + 4 * 4 + 8 + 4);
+    catalogue.buses_.resize(bus_count);
+    catalogue.bus_lengths_.resize(bus_count);
+    std::vector<bool> present_buses(bus_count);
+    for (size_t i = 0; i < bus_count; ++i) {
+        Bus& bus = catalogue.buses_[i];
+        bus.name = name(reader.Index(names.size()));
+        present_buses[i] = reader.Bool();
+        bus.is_roundtrip = reader.Bool();
+        bus.id = static_cast<uint32_t>(i);
+        bus.stops = StopSequence(reader.Count(4), catalogue.GetAllocator<const Stop*>());
+        for (const Stop*& stop : bus.stops) {
+            stop = &catalogue.stops_[reader.Index(stop_count)];
+        }
+        BusRoutInfo info;
+        info.count_stops = reader.U32();
+        info.count_uniq_stops = reader.U32();
+        info.lenght = reader.U32();
+        info.curvature = reader.F64();
+        const size_t point_count = reader.Count(4 + 8);
+        SnapshotReader::Check(point_count == bus.GetRoute().size());
+        auto& lengths = catalogue.bus_lengths_[i];
+        lengths = catalogue.MakeRouteLengths(point_count);
+        lengths.info = info;
+        for (unsigned int& road : lengths.road) {
+            road = reader.U32();
+        }
+        for (double& geo : lengths.geo) {
+            geo = reader.F64();
+        }
+    }
+    catalogue.bus_ptrs_.reserve(bus_count);
+    for (const Bus& bus : catalogue.buses_) {
+        if (present_buses[bus.id]) {
+            catalogue.bus_ptrs_[bus.name] = &bus;
+        }
+    }
+
+    const size_t stop_name_count = reader.Count(4 + 4);
+    SnapshotReader::Check(stop_name_count == catalogue.stop_ptrs_.size());
+    catalogue.buses_on_stop_.reserve(stop_count);
+    for (size_t i = 0; i < stop_name_count; ++i) {
+        const std::string_view stop = name(reader.Index(names.size()));
+        auto [it, inserted] = catalogue.buses_on_stop_.try_emplace(stop, catalogue.GetAllocator<std::string_view>());
+        SnapshotReader::Check(inserted && catalogue.stop_ptrs_.count(stop) > 0);
+        const size_t count = reader.Count(4);
+        for (size_t j = 0; j < count; ++j) {
+            const std::string_view bus = name(reader.Index(names.size()));
+            SnapshotReader::Check(it->second.empty() || *it->second.rbegin() < bus);
+            it->second.insert(it->second.end(), bus);
+        }
+    }
+
+    catalogue.stop_hash_ = ReadHash(reader, catalogue.stop_ptrs_.size());
+    catalogue.stop_slots_.resize(catalogue.stop_hash_.GetSize());
+    for (auto& slot : catalogue.stop_slots_) {
+        const Stop& stop = catalogue.stops_[reader.Index(stop_count)];
+        const auto it = catalogue.stop_ptrs_.find(stop.name);
+        SnapshotReader::Check(it != catalogue.stop_ptrs_.end() && it->second == &stop);
+        slot = {stop.name, &stop, &catalogue.buses_on_stop_.at(stop.name)};
+    }
+    // Каждое имя должно находиться по своему хешу, иначе поиск по имени промахнётся
+    for (size_t i = 0; i < catalogue.stop_slots_.size(); ++i) {
+        SnapshotReader::Check(catalogue.stop_hash_(catalogue.stop_slots_[i].name) == i);
+    }
+    catalogue.bus_hash_ = ReadHash(reader, catalogue.bus_ptrs_.size());
+    catalogue.bus_slots_.resize(catalogue.bus_hash_.GetSize());
+    for (auto& slot : catalogue.bus_slots_) {
+        const Bus& bus = catalogue.buses_[reader.Index(bus_count)];
+        const auto it = catalogue.bus_ptrs_.find(bus.name);
+        SnapshotReader::Check(it != catalogue.bus_ptrs_.end() && it->second == &bus);
+        slot = {bus.name, &bus};
+    }
+    for (size_t i = 0; i < catalogue.bus_slots_.size(); ++i) {
+        SnapshotReader::Check(catalogue.bus_hash_(catalogue.bus_slots_[i].name) == i);
+    }
+    SnapshotReader::Check(reader.AtEnd());
+
+    catalogue.frozen_ = true;
+    return catalogue;
+}
+
+}  // namespace catalogue
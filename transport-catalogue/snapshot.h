@@ -0,0 +1,38 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "transport_catalogue.h"
+
+namespace catalogue {
+
+/*
+ * Двоичный снимок замороженного справочника: имена, остановки с координатами, расстояния,
+ * маршруты с последовательностями остановок и готовой статистикой, множества маршрутов
+ * остановок и совершенные хеши имён. Загрузка не разбирает JSON и ничего не пересчитывает.
+ *
+ * Все числа - little-endian фиксированной ширины, double хранится битовым образом IEEE 754,
+ * поэтому файл переносим между платформами. Остановки и маршруты, удалённые через ApplyDelta(),
+ * хранятся с признаком "не действует", чтобы не менять id остальных. Формат (u32, если не сказано иное):
+ *   "TCATSNAP", версия, флаги (0)
+ *   имена:      количество, длины, затем все строки подряд; номер имени - его Symbol
+ *   остановки:  количество; имя, действует (u8), lat (f64), lng (f64)
+ *   расстояния: для каждой остановки - количество соседей; сосед, расстояние, is_direct (u8)
+ *   маршруты:   количество; имя, действует (u8), is_roundtrip (u8), количество и номера остановок,
+ *               статистика (остановок, уникальных, длина, извилистость f64),
+ *               количество точек пути, префиксные суммы длин по дорогам и по прямой (f64)
+ *   маршруты остановок: количество; имя остановки, количество и имена маршрутов по порядку
+ *   индексы остановок и маршрутов: размер, seed (u64), количество и смещения корзин,
+ *               номера остановок (маршрутов) по номерам хеша
+ */
+inline constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+// Справочник должен быть заморожен, иначе std::logic_error
+void WriteSnapshot(const TransportCatalogue& catalogue, std::ostream& output);
+
+// Файл отображается в память, имена справочника остаются строками в отображении.
+// Возвращает замороженный справочник; повреждённый или чужой файл - std::runtime_error
+TransportCatalogue LoadSnapshot(const std::string& path);
+
+}  // namespace catalogue
@@ -0,0 +1,71 @@
+#include "string_interner.h"
+
+#include <algorithm>
+
+namespace catalogue {
+
+Symbol StringInterner::Intern(std::string_view value) {
+    if (const auto it = ids_.find(value); it != ids_.end()) {
+        return {it->second};
+    }
+    const std::string_view stored = Store(value);
+    const uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(stored);
+    ids_.emplace(stored, id);
+    return {id};
+}
+
+void StringInterner::AddExternal(const std::vector<std::string_view>& values, std::shared_ptr<const void> owner) {
+    Reserve(strings_.size() + values.size());
+    for (const std::string_view value : values) {
+        const uint32_t id = static_cast<uint32_t>(strings_.size());
+        if (ids_.emplace(value, id).second) {
+            strings_.push_back(value);
+        }
+    }
+    external_owners_.push_back(std::move(owner));
+}
+
+StringInterner StringInterner::Share() const {
+    StringInterner result;
+    result.blocks_ = blocks_;
+    result.external_owners_ = external_owners_;
+    result.strings_ = strings_;
+    result.ids_ = ids_;
+    // Свободное место текущего блока остаётся за этим интернером
+    return result;
+}
+
+std::optional<Symbol> StringInterner::Find(std::string_view value) const {
+    if (const auto it = ids_.find(value); it != ids_.end()) {
+        return Symbol{it->second};
+    }
+    return std::nullopt;
+}
+
+void StringInterner::Reserve(size_t count) {
+    strings_.reserve(count);
+    ids_.reserve(count);
+}
+
+// Длинные строки получают собственный блок, остальные дописываются в текущий
+std::string_view StringInterner::Store(std::string_view value) {
+    if (value.size() > block_free_) {
+        const size_t size = std::max(BLOCK_SIZE, value.size());
+        blocks_.emplace_back(new char[size]);
+        if (size == BLOCK_SIZE) {
+            block_pos_ = blocks_.back().get();
+            block_free_ = size;
+        } else {
+            std::copy(value.begin(), value.end(), blocks_.back().get());
+            return {blocks_.back().get(), value.size()};
+        }
+    }
+    char* begin = block_pos_;
+    std::copy(value.begin(), value.end(), begin);
+    block_pos_ += value.size();
+    block_free_ -= value.size();
+    return {begin, value.size()};
+}
+
+}  // namespace catalogue
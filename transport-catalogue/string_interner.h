@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace catalogue {
+
+// Номер строки в StringInterner. Символы выдаются подряд с 0 и не меняются
+struct Symbol {
+    uint32_t id = 0;
+
+    bool operator==(Symbol other) const {
+        return id == other.id;
+    }
+    bool operator!=(Symbol other) const {
+        return id != other.id;
+    }
+};
+
+// Хранит по одной копии каждой строки. Строки лежат в крупных блоках и не перемещаются,
+// поэтому std::string_view на них действительны, пока жив интернер (в том числе после перемещения)
+class StringInterner {
+public:
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    StringInterner(StringInterner&&) = default;
+    StringInterner& operator=(StringInterner&&) = default;
+
+    // Символ строки; при первой встрече строка копируется
+    Symbol Intern(std::string_view value);
+    // Добавляет строки без копирования, символы выдаются по порядку. Строки лежат во внешнем
+    // буфере (например, в отображённом в память файле), который owner держит живым
+    void AddExternal(const std::vector<std::string_view>& values, std::shared_ptr<const void> owner);
+    // Копия с теми же символами, которая делит с этим интернером уже сохранённые строки.
+    // Новые строки каждый из них хранит в своих блоках
+    StringInterner Share() const;
+    std::optional<Symbol> Find(std::string_view value) const;
+
+    std::string_view GetString(Symbol symbol) const {
+        return strings_[symbol.id];
+    }
+    size_t GetSize() const {
+        return strings_.size();
+    }
+    void Reserve(size_t count);
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::shared_ptr<char[]>> blocks_;
+    std::vector<std::shared_ptr<const void>> external_owners_;
+    char* block_pos_ = nullptr;
+    size_t block_free_ = 0;
+
+    // Индекс - Symbol::id
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+
+    std::string_view Store(std::string_view value);
+};
+
+}  // namespace catalogue
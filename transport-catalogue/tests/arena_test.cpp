@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../arena.h"
+#include "../transport_catalogue.h"
+#include "test_framework.h"
+
+using catalogue::Arena;
+using catalogue::ArenaAllocator;
+using catalogue::ArenaStats;
+using catalogue::TransportCatalogue;
+
+TEST(ArenaStatsCountsAllocations) {
+    Arena arena;
+    ASSERT_EQUAL(arena.GetStats().allocations, 0u);
+    ASSERT_EQUAL(arena.GetStats().blocks, 0u);
+
+    void* first = arena.Allocate(100, 8);
+    void* second = arena.Allocate(24, 64);
+    ASSERT(first != second);
+    ASSERT_EQUAL(reinterpret_cast<uintptr_t>(second) % 64, 0u);
+    ArenaStats stats = arena.GetStats();
+    ASSERT_EQUAL(stats.allocations, 2u);
+    ASSERT_EQUAL(stats.allocated_bytes, 124u);
+    ASSERT_EQUAL(stats.freed_bytes, 0u);
+    ASSERT_EQUAL(stats.blocks, 1u);
+    ASSERT(stats.reserved_bytes >= stats.allocated_bytes);
+
+    arena.Deallocate(24);
+    stats = arena.GetStats();
+    ASSERT_EQUAL(stats.freed_bytes, 24u);
+    ASSERT_EQUAL(stats.allocated_bytes, 124u);
+}
+
+// Крупное выделение получает свой блок, а мелкие продолжают заполнять текущий
+TEST(ArenaLargeAllocationGetsOwnBlock) {
+    Arena arena;
+    arena.Allocate(16, 8);
+    const size_t reserved = arena.GetStats().reserved_bytes;
+    arena.Allocate(1024 * 1024, 8);
+    ArenaStats stats = arena.GetStats();
+    ASSERT_EQUAL(stats.blocks, 2u);
+    ASSERT(stats.reserved_bytes >= reserved + 1024 * 1024);
+    arena.Allocate(16, 8);
+    ASSERT_EQUAL(arena.GetStats().blocks, 2u);
+}
+
+TEST(ArenaConcurrentAllocationsDoNotOverlap) {
+    Arena arena;
+    constexpr size_t THREADS = 4;
+    constexpr size_t PER_THREAD = 5000;
+    std::vector<std::vector<char*>> results(THREADS);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&arena, &result = results[t], t] {
+            for (size_t i = 0; i < PER_THREAD; ++i) {
+                char* data = static_cast<char*>(arena.Allocate(24, 8));
+                std::memset(data, static_cast<int>(t), 24);
+                result.push_back(data);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 0; t < THREADS; ++t) {
+        for (const char* data : results[t]) {
+            for (size_t i = 0; i < 24; ++i) {
+                ASSERT_EQUAL(data[i], static_cast<char>(t));
+            }
+        }
+    }
+    const ArenaStats stats = arena.GetStats();
+    ASSERT_EQUAL(stats.allocations, THREADS * PER_THREAD);
+    ASSERT_EQUAL(stats.allocated_bytes, THREADS * PER_THREAD * 24);
+}
+
+// Освобождённое контейнером учитывается, а копия контейнера живёт в куче
+TEST(ArenaAllocatorAccounting) {
+    const auto arena = std::make_shared<Arena>();
+    {
+        std::vector<uint64_t, ArenaAllocator<uint64_t>> values{ArenaAllocator<uint64_t>(arena)};
+        values.reserve(10);
+        ASSERT_EQUAL(arena->GetStats().allocated_bytes, 80u);
+        values.assign(20, 1);
+        ASSERT_EQUAL(arena->GetStats().allocated_bytes, 80u + 160u);
+        ASSERT_EQUAL(arena->GetStats().freed_bytes, 80u);
+
+        const auto copy = values;
+        ASSERT(copy.get_allocator() == ArenaAllocator<uint64_t>());
+        ASSERT_EQUAL(arena->GetStats().allocations, 2u);
+    }
+    const ArenaStats stats = arena->GetStats();
+    ASSERT_EQUAL(stats.freed_bytes, stats.allocated_bytes);
+}
+
+// Повторные замены маршрута освобождают память в арене; ApplyDelta() сжимает арену,
+// не давая освобождённому превысить занятое
+TEST(CatalogueArenaWasteStaysBounded) {
+    TransportCatalogue::BulkData data;
+    std::vector<std::string> names;
+    for (int i = 0; i < 500; ++i) {
+        names.push_back("Stop " + std::to_string(i));
+    }
+    for (int i = 0; i < 500; ++i) {
+        data.stops.push_back({names[i], {55.5 + i * 0.001, 37.5 + (i % 7) * 0.001}});
+        if (i > 0) {
+            data.distances.push_back({names[i - 1], names[i], 100u + i});
+        }
+    }
+    data.buses.push_back({"X", {names.begin(), names.end()}, false});
+    TransportCatalogue catalogue;
+    catalogue.Load(std::move(data));
+    catalogue.Freeze();
+    ASSERT(catalogue.GetArenaStats().allocations > 0);
+
+    const unsigned int length = catalogue.GetRouteInfo("X").lenght;
+    size_t max_reserved = 0;
+    bool compacted = false;
+    size_t previous_freed = 0;
+    for (int i = 0; i < 200; ++i) {
+        TransportCatalogue::DeltaData delta;
+        delta.buses = {{TransportCatalogue::DeltaAction::REPLACE, {"X", {names.begin(), names.end()}, false}}};
+        catalogue.ApplyDelta(delta);
+        const ArenaStats stats = catalogue.GetArenaStats();
+        ASSERT(stats.freed_bytes <= stats.allocated_bytes - stats.freed_bytes || stats.freed_bytes < 1024 * 1024);
+        compacted = compacted || stats.freed_bytes < previous_freed;
+        previous_freed = stats.freed_bytes;
+        max_reserved = std::max(max_reserved, stats.reserved_bytes);
+    }
+    ASSERT(compacted);
+    ASSERT(max_reserved < 16 * 1024 * 1024);
+    ASSERT_EQUAL(catalogue.GetRouteInfo("X").lenght, length);
+}
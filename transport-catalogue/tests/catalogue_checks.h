@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstring>
+
+#include "../transport_catalogue.h"
+#include "test_framework.h"
+
+namespace testing {
+
+// Справочники отвечают одинаково: те же имена, статистика маршрутов (извилистость - побитово),
+// длины маршрутов по дорогам, маршруты остановок, координаты и расстояния между остановками
+inline void CheckSameCatalogue(const catalogue::TransportCatalogue& expected, const catalogue::TransportCatalogue& actual) {
+    ASSERT_EQUAL(actual.GetAllBuses().size(), expected.GetAllBuses().size());
+    ASSERT_EQUAL(actual.GetAllStops().size(), expected.GetAllStops().size());
+    for (const auto& [name, bus] : expected.GetAllBuses()) {
+        const catalogue::BusRoutInfo lhs = expected.GetRouteInfo(name);
+        const catalogue::BusRoutInfo rhs = actual.GetRouteInfo(name);
+        ASSERT_EQUAL(rhs.count_stops, lhs.count_stops);
+        ASSERT_EQUAL(rhs.count_uniq_stops, lhs.count_uniq_stops);
+        ASSERT_EQUAL(rhs.lenght, lhs.lenght);
+        ASSERT_EQUAL(std::memcmp(&rhs.curvature, &lhs.curvature, sizeof(double)), 0);
+        const catalogue::Bus* other = actual.GetAllBuses().at(name);
+        const size_t last = bus->GetRoute().size() - 1;
+        ASSERT_EQUAL(other->GetRoute().size(), last + 1);
+        ASSERT_EQUAL(actual.GetRoadDistanceOnRoute(other, 0, last), expected.GetRoadDistanceOnRoute(bus, 0, last));
+    }
+    for (const auto& [name, stop] : expected.GetAllStops()) {
+        ASSERT_EQUAL(actual.GetStopInfo(name), expected.GetStopInfo(name));
+        const catalogue::Stop* other = actual.GetStopByName(name).value();
+        ASSERT(other->coord == stop->coord);
+        for (const auto& [to_name, to] : expected.GetAllStops()) {
+            ASSERT_EQUAL(actual.GetStopsDistance(other, actual.GetStopByName(to_name).value()),
+                         expected.GetStopsDistance(stop, to));
+        }
+    }
+}
+
+}  // namespace testing
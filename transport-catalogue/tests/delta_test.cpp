@@ -0,0 +1,157 @@
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "../transport_catalogue.h"
+#include "catalogue_checks.h"
+#include "test_framework.h"
+
+using catalogue::TransportCatalogue;
+using Action = TransportCatalogue::DeltaAction;
+
+namespace {
+
+TransportCatalogue::BulkData MakeBaseData() {
+    TransportCatalogue::BulkData data;
+    data.stops = {{"A", {55.611087, 37.20829}},
+                  {"B", {55.595884, 37.209755}},
+                  {"C", {55.632761, 37.333324}},
+                  {"D", {55.574371, 37.6517}},
+                  {"E", {55.587655, 37.645687}}};
+    data.distances = {{"A", "B", 3900}, {"B", "A", 4100}, {"B", "C", 9900},
+                      {"C", "D", 2600}, {"D", "E", 1380}, {"E", "C", 2500}};
+    data.buses = {{"X", {"A", "B", "C"}, false},
+                  {"Z", {"C", "D", "E", "C"}, true}};
+    return data;
+}
+
+TransportCatalogue Build(TransportCatalogue::BulkData data) {
+    TransportCatalogue catalogue;
+    catalogue.Load(std::move(data));
+    catalogue.Freeze();
+    return catalogue;
+}
+
+void RemoveStop(TransportCatalogue::BulkData& data, std::string_view name) {
+    std::vector<TransportCatalogue::StopRecord> stops;
+    for (const auto& stop : data.stops) {
+        if (stop.name != name) {
+            stops.push_back(stop);
+        }
+    }
+    data.stops = std::move(stops);
+    std::vector<TransportCatalogue::DistanceRecord> distances;
+    for (const auto& distance : data.distances) {
+        if (distance.from != name && distance.to != name) {
+            distances.push_back(distance);
+        }
+    }
+    data.distances = std::move(distances);
+}
+
+void RemoveDistance(TransportCatalogue::BulkData& data, std::string_view from, std::string_view to) {
+    std::vector<TransportCatalogue::DistanceRecord> distances;
+    for (const auto& distance : data.distances) {
+        if (distance.from != from || distance.to != to) {
+            distances.push_back(distance);
+        }
+    }
+    data.distances = std::move(distances);
+}
+
+}  // namespace
+
+TEST(DeltaMatchesFullRebuild) {
+    TransportCatalogue catalogue = Build(MakeBaseData());
+    TransportCatalogue::DeltaData delta;
+    delta.stops = {{Action::REPLACE, {"B", {55.6, 37.3}}},
+                   {Action::ADD, {"F", {55.62, 37.4}}},
+                   {Action::REMOVE, {"E", {}}}};
+    delta.distances = {{Action::ADD, {"C", "F", 1200}},
+                       {Action::REPLACE, {"A", "B", 3000}}};
+    delta.buses = {{Action::REMOVE, {"Z", {}, false}},
+                   {Action::ADD, {"Y", {"C", "F", "D", "C"}, true}},
+                   {Action::REPLACE, {"X", {"A", "B", "D"}, false}}};
+    catalogue.ApplyDelta(delta);
+
+    TransportCatalogue::BulkData expected = MakeBaseData();
+    expected.stops[1].coord = {55.6, 37.3};
+    expected.stops.push_back({"F", {55.62, 37.4}});
+    RemoveStop(expected, "E");
+    RemoveDistance(expected, "A", "B");
+    expected.distances.push_back({"A", "B", 3000});
+    expected.distances.push_back({"C", "F", 1200});
+    expected.buses = {{"X", {"A", "B", "D"}, false},
+                      {"Y", {"C", "F", "D", "C"}, true}};
+    testing::CheckSameCatalogue(Build(std::move(expected)), catalogue);
+    ASSERT(!catalogue.GetStopByName("E").has_value());
+    ASSERT_THROWS(catalogue.GetRouteInfo("Z"), catalogue::TransportCatalogueException);
+}
+
+// Участок без прямого расстояния берёт обратное, а без обоих - нулевое
+TEST(DeltaRemoveDistanceFallsBackToReverse) {
+    TransportCatalogue catalogue = Build(MakeBaseData());
+    // ApplyDelta() может перенести справочник в новую арену, поэтому остановки ищутся заново
+    const auto distance = [&catalogue](std::string_view from, std::string_view to) {
+        return catalogue.GetStopsDistance(catalogue.GetStopByName(from).value(), catalogue.GetStopByName(to).value());
+    };
+
+    TransportCatalogue::DeltaData delta;
+    delta.distances = {{Action::REMOVE, {"A", "B", 0}}};
+    catalogue.ApplyDelta(delta);
+    ASSERT_EQUAL(distance("A", "B"), 4100u);
+    ASSERT_EQUAL(distance("B", "A"), 4100u);
+    TransportCatalogue::BulkData expected = MakeBaseData();
+    RemoveDistance(expected, "A", "B");
+    testing::CheckSameCatalogue(Build(expected), catalogue);
+
+    // Расстояние A -> B теперь взято из обратного, удалить его нельзя
+    ASSERT_THROWS(catalogue.ApplyDelta(delta), std::invalid_argument);
+
+    delta.distances = {{Action::REMOVE, {"B", "A", 0}}};
+    catalogue.ApplyDelta(delta);
+    ASSERT_EQUAL(distance("A", "B"), 0u);
+    ASSERT_EQUAL(distance("B", "A"), 0u);
+    RemoveDistance(expected, "B", "A");
+    testing::CheckSameCatalogue(Build(std::move(expected)), catalogue);
+}
+
+TEST(DeltaRejectsInvalidRecords) {
+    TransportCatalogue not_frozen;
+    ASSERT_THROWS(not_frozen.ApplyDelta({}), std::logic_error);
+
+    TransportCatalogue catalogue = Build(MakeBaseData());
+    const auto apply = [&catalogue](TransportCatalogue::DeltaData delta) {
+        catalogue.ApplyDelta(delta);
+    };
+    ASSERT_THROWS(apply({{{Action::ADD, {"A", {55.0, 37.0}}}}, {}, {}}), std::invalid_argument);
+    ASSERT_THROWS(apply({{{Action::REMOVE, {"C", {}}}}, {}, {}}), std::invalid_argument);
+    ASSERT_THROWS(apply({{{Action::REPLACE, {"Q", {55.0, 37.0}}}}, {}, {}}), std::out_of_range);
+    ASSERT_THROWS(apply({{}, {{Action::REMOVE, {"A", "C", 0}}}, {}}), std::invalid_argument);
+    ASSERT_THROWS(apply({{}, {{Action::ADD, {"A", "Q", 10}}}, {}}), std::out_of_range);
+    ASSERT_THROWS(apply({{}, {}, {{Action::ADD, {"X", {"A", "B"}, false}}}}), std::invalid_argument);
+    ASSERT_THROWS(apply({{}, {}, {{Action::ADD, {"W", {"A", "Q"}, false}}}}), std::out_of_range);
+    ASSERT_THROWS(apply({{}, {}, {{Action::REMOVE, {"W", {}, false}}}}), std::out_of_range);
+    // Отвергнутые записи ничего не поменяли
+    testing::CheckSameCatalogue(Build(MakeBaseData()), catalogue);
+}
+
+// Записи до ошибочной остаются в силе вместе со статистикой маршрутов
+TEST(DeltaErrorKeepsAppliedRecords) {
+    TransportCatalogue catalogue = Build(MakeBaseData());
+    TransportCatalogue::DeltaData delta;
+    delta.stops = {{Action::REPLACE, {"B", {55.6, 37.3}}},
+                   {Action::REMOVE, {"A", {}}}};
+    delta.distances = {{Action::ADD, {"B", "D", 700}}};
+    delta.buses = {{Action::ADD, {"Y", {"B", "D"}, false}}};
+    ASSERT_THROWS(catalogue.ApplyDelta(delta), std::invalid_argument);
+
+    TransportCatalogue::BulkData expected = MakeBaseData();
+    expected.stops[1].coord = {55.6, 37.3};
+    expected.distances.push_back({"B", "D", 700});
+    expected.buses.push_back({"Y", {"B", "D"}, false});
+    testing::CheckSameCatalogue(Build(std::move(expected)), catalogue);
+    const catalogue::Bus* bus = catalogue.GetAllBuses().at("Y");
+    ASSERT_EQUAL(catalogue.GetRouteInfo("Y").lenght, 1400u);
+    ASSERT_EQUAL(catalogue.GetRoadDistanceOnRoute(bus, 0, 2), 1400u);
+}
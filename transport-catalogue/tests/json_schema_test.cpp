@@ -0,0 +1,112 @@
+#include <string>
+#include <vector>
+
+#include "../json_reader.h"
+#include "../json_schema.h"
+#include "test_framework.h"
+
+namespace {
+
+struct Point {
+    int x = 0;
+    int y = 0;
+    std::vector<int> tags;
+};
+
+}  // namespace
+
+template <>
+struct json::schema::Descriptor<Point> {
+    static constexpr auto fields = std::make_tuple(
+        Required("x", &Point::x),
+        Optional("y", &Point::y),
+        Optional("tags", &Point::tags));
+};
+
+namespace {
+
+const std::vector<CommandDescription>& ReadCommands(JsonReader& reader) {
+    reader.ReadAndParse();
+    return reader.GetCommandsDescription();
+}
+
+}  // namespace
+
+TEST(SchemaParsesKnownFields) {
+    Point point;
+    json::schema::Parse(R"({"x": 1, "unknown": {"x": [5]}, "tags": [2, 3]})", point);
+    ASSERT_EQUAL(point.x, 1);
+    ASSERT_EQUAL(point.y, 0);
+    ASSERT(point.tags == std::vector<int>({2, 3}));
+    Point missing;
+    ASSERT_THROWS(json::schema::Parse(R"({"y": 1})", missing), std::out_of_range);
+}
+
+// Повторный ключ не перезаписывает скаляр и не дополняет массив, как в json::Load
+TEST(SchemaRejectsDuplicateKeys) {
+    Point point;
+    ASSERT_THROWS(json::schema::Parse(R"({"x": 1, "x": 2})", point), json::ParsingError);
+    Point tags;
+    ASSERT_THROWS(json::schema::Parse(R"({"x": 1, "tags": [1], "tags": [2]})", tags), json::ParsingError);
+    // Повторы внутри разных словарей - не повторы
+    std::vector<Point> points;
+    json::schema::Parse(R"([{"x": 1}, {"x": 2}])", points);
+    ASSERT_EQUAL(points.size(), 2u);
+}
+
+TEST(ReaderRejectsDuplicateCommandKeys) {
+    const std::string stops = R"({"base_requests": [{"type": "Bus", "name": "1", "stops": ["A"], "stops": ["B"], "is_roundtrip": true}]})";
+    JsonReader stops_reader{std::string_view(stops)};
+    ASSERT_THROWS(ReadCommands(stops_reader), json::ParsingError);
+
+    const std::string distances = R"({"base_requests": [{"type": "Stop", "name": "A", "latitude": 55.0, "longitude": 37.0,
+                                                          "road_distances": {"B": 100, "B": 200}}]})";
+    JsonReader distances_reader{std::string_view(distances)};
+    ASSERT_THROWS(ReadCommands(distances_reader), json::ParsingError);
+
+    const std::string valid = R"({"base_requests": [{"type": "Stop", "name": "A", "latitude": 55.0, "longitude": 37.0,
+                                                      "road_distances": {"B": 100, "C": 200}}]})";
+    JsonReader valid_reader{std::string_view(valid)};
+    const auto& commands = ReadCommands(valid_reader);
+    ASSERT_EQUAL(commands.size(), 1u);
+    ASSERT_EQUAL(commands[0].road_distances.size(), 2u);
+    ASSERT_EQUAL(commands[0].road_distances[1].dist, 200);
+}
+
+// Строки без escape-последовательностей не копируются, раскрытые живут в хранилище ридера
+TEST(ReaderCommandStringsReferenceInput) {
+    const std::string input = R"({"base_requests": [{"type": "Bus", "name": "Bus \"1\"", "stops": ["A", "B\\C"],
+                                                      "is_roundtrip": true}]})";
+    JsonReader reader{std::string_view(input)};
+    const auto& commands = ReadCommands(reader);
+    ASSERT_EQUAL(commands.size(), 1u);
+    const auto in_input = [&input](std::string_view value) {
+        return value.data() >= input.data() && value.data() + value.size() <= input.data() + input.size();
+    };
+    ASSERT(in_input(commands[0].type));
+    ASSERT(in_input(commands[0].stops[0]));
+    ASSERT_EQUAL(commands[0].name, std::string_view("Bus \"1\""));
+    ASSERT_EQUAL(commands[0].stops[1], std::string_view("B\\C"));
+    ASSERT(!in_input(commands[0].name));
+
+    // Без хранилища ссылке на строку парсера не на что указывать
+    std::string_view name;
+    ASSERT_THROWS(json::schema::Parse(R"("A")", name), std::logic_error);
+}
+
+TEST(SplitArrayPassesChunks) {
+    std::vector<std::vector<std::string_view>> chunks;
+    const auto collect = [&chunks](const std::vector<std::string_view>& chunk) {
+        chunks.push_back(chunk);
+    };
+    ASSERT(json::SplitArray(R"([1, [2, 3], {"a": 4}, "5", 6])", 2, collect));
+    ASSERT_EQUAL(chunks.size(), 3u);
+    ASSERT(chunks[1] == std::vector<std::string_view>({R"({"a": 4})", R"("5")"}));
+    ASSERT_EQUAL(chunks[2].size(), 1u);
+
+    // Куски до ошибки уже переданы
+    chunks.clear();
+    ASSERT_THROWS(json::SplitArray("[1, 2, 3", 2, collect), json::ParsingError);
+    ASSERT_EQUAL(chunks.size(), 1u);
+    ASSERT(!json::SplitArray(R"({"a": 1})", 2, collect));
+}
@@ -0,0 +1,22 @@
+#include <exception>
+#include <iostream>
+
+#include "test_framework.h"
+
+int main() {
+    int failed = 0;
+    for (const testing::TestCase& test : testing::GetTests()) {
+        try {
+            test.func();
+            std::cerr << test.name << " OK" << std::endl;
+        } catch (const std::exception& e) {
+            ++failed;
+            std::cerr << test.name << " FAIL: " << e.what() << std::endl;
+        }
+    }
+    if (failed != 0) {
+        std::cerr << failed << " of " << testing::GetTests().size() << " tests failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
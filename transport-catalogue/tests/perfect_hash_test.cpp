@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../perfect_hash.h"
+#include "test_framework.h"
+
+using catalogue::PerfectHash;
+
+namespace {
+
+std::vector<std::string> MakeNames(size_t count) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back("Stop " + std::to_string(i * 7919));
+    }
+    return names;
+}
+
+std::vector<std::string_view> ToViews(const std::vector<std::string>& names) {
+    return {names.begin(), names.end()};
+}
+
+// Номера ключей различны и покрывают [0, n)
+void CheckBijection(const PerfectHash& hash, const std::vector<std::string_view>& keys) {
+    std::vector<bool> taken(keys.size(), false);
+    for (const std::string_view key : keys) {
+        const size_t slot = hash(key);
+        ASSERT(slot < keys.size());
+        ASSERT(!taken[slot]);
+        taken[slot] = true;
+    }
+}
+
+}  // namespace
+
+TEST(PerfectHashEmpty) {
+    const PerfectHash hash(std::vector<std::string_view>{});
+    ASSERT_EQUAL(hash.GetSize(), 0u);
+    ASSERT_EQUAL(hash("missing"), 0u);
+}
+
+TEST(PerfectHashSingleKey) {
+    const PerfectHash hash(std::vector<std::string_view>{"Marushkino"});
+    ASSERT_EQUAL(hash.GetSize(), 1u);
+    ASSERT_EQUAL(hash("Marushkino"), 0u);
+    ASSERT_EQUAL(hash("Tolstopaltsevo"), 0u);
+    ASSERT_EQUAL(hash(""), 0u);
+}
+
+TEST(PerfectHashIsMinimalAndPerfect) {
+    for (const size_t count : {2u, 3u, 4u, 5u, 17u, 100u, 1000u, 10000u}) {
+        const auto names = MakeNames(count);
+        const PerfectHash hash(ToViews(names));
+        ASSERT_EQUAL(hash.GetSize(), count);
+        CheckBijection(hash, ToViews(names));
+    }
+}
+
+// Промах даёт номер из диапазона; отличить его можно только сравнением с ключом по номеру
+TEST(PerfectHashMissesStayInRange) {
+    const auto names = MakeNames(500);
+    const auto keys = ToViews(names);
+    const PerfectHash hash(keys);
+    std::vector<std::string_view> by_slot(keys.size());
+    for (const std::string_view key : keys) {
+        by_slot[hash(key)] = key;
+    }
+    for (const std::string_view miss : {"", "Stop", "Stop 1", "Stop 7919 ", "a somewhat longer missing key"}) {
+        const size_t slot = hash(miss);
+        ASSERT(slot < keys.size());
+        ASSERT(by_slot[slot] != miss);
+    }
+}
+
+TEST(PerfectHashRestoresFromParts) {
+    const auto names = MakeNames(300);
+    const auto keys = ToViews(names);
+    const PerfectHash hash(keys);
+    const PerfectHash restored(hash.GetSize(), hash.GetSeed(), hash.GetDisplacements());
+    for (const std::string_view key : keys) {
+        ASSERT_EQUAL(restored(key), hash(key));
+        ASSERT_EQUAL(PerfectHash::Slot(key, hash.GetSize(), hash.GetSeed(),
+                                       hash.GetDisplacements().data(), hash.GetDisplacements().size()),
+                     hash(key));
+    }
+}
+
+// Функция сохраняется в снимок, поэтому хеш не должен зависеть от платформы
+TEST(PerfectHashStableHash) {
+    ASSERT_EQUAL(PerfectHash::Hash("Biryulyovo Zapadnoye", 1), 0xBBDA01EE9178595Aull);
+    ASSERT_EQUAL(PerfectHash::Hash("", 1), 0x9E0160293A33AAF7ull);
+    ASSERT(PerfectHash::Hash("Biryulyovo Zapadnoye", 1) != PerfectHash::Hash("Biryulyovo Zapadnoye", 2));
+    ASSERT(PerfectHash::Hash("", 1) != PerfectHash::Hash(std::string_view("\0", 1), 1));
+}
+
+TEST(PerfectHashRejectsDuplicates) {
+    ASSERT_THROWS(PerfectHash(std::vector<std::string_view>{"A", "B", "A"}), std::invalid_argument);
+}
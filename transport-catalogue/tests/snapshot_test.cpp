@@ -0,0 +1,146 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../snapshot.h"
+#include "catalogue_checks.h"
+#include "test_framework.h"
+
+using catalogue::TransportCatalogue;
+
+namespace {
+
+const std::string SNAPSHOT_PATH = (std::filesystem::temp_directory_path() / "catalogue_snapshot_test.snap").string();
+
+TransportCatalogue MakeCatalogue(bool single_bus = false) {
+    TransportCatalogue::BulkData data;
+    data.stops = {{"Tolstopaltsevo", {55.611087, 37.20829}},
+                  {"Marushkino", {55.595884, 37.209755}},
+                  {"Rasskazovka", {55.632761, 37.333324}},
+                  {"Biryulyovo Zapadnoye", {55.574371, 37.6517}}};
+    data.distances = {{"Tolstopaltsevo", "Marushkino", 3900},
+                      {"Marushkino", "Rasskazovka", 9900},
+                      {"Rasskazovka", "Marushkino", 9500},
+                      {"Biryulyovo Zapadnoye", "Rasskazovka", 1800}};
+    data.buses = {{"750", {"Tolstopaltsevo", "Marushkino", "Rasskazovka"}, false}};
+    if (!single_bus) {
+        data.buses.push_back({"256", {"Biryulyovo Zapadnoye", "Rasskazovka", "Marushkino", "Biryulyovo Zapadnoye"}, true});
+    }
+    TransportCatalogue catalogue;
+    catalogue.Load(std::move(data));
+    catalogue.Freeze();
+    return catalogue;
+}
+
+std::string WriteToString(const TransportCatalogue& catalogue) {
+    std::ostringstream output;
+    catalogue::WriteSnapshot(catalogue, output);
+    return output.str();
+}
+
+TransportCatalogue LoadFromString(const std::string& bytes) {
+    {
+        std::ofstream output(SNAPSHOT_PATH, std::ios::binary | std::ios::trunc);
+        output.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    return catalogue::LoadSnapshot(SNAPSHOT_PATH);
+}
+
+uint32_t ReadU32(const std::string& bytes, size_t pos) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[pos + i])) << (8 * i);
+    }
+    return value;
+}
+
+void WriteU32(std::string& bytes, size_t pos, uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) {
+        bytes[pos + i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+}  // namespace
+
+TEST(SnapshotRoundTrip) {
+    const TransportCatalogue catalogue = MakeCatalogue();
+    const std::string bytes = WriteToString(catalogue);
+    const TransportCatalogue loaded = LoadFromString(bytes);
+    ASSERT(loaded.IsFrozen());
+    testing::CheckSameCatalogue(catalogue, loaded);
+    ASSERT(!loaded.GetStopByName("Universam").has_value());
+    ASSERT_THROWS(loaded.GetRouteInfo("828"), catalogue::TransportCatalogueException);
+    // Повторная запись загруженного снимка даёт тот же файл
+    ASSERT_EQUAL(WriteToString(loaded), bytes);
+}
+
+TEST(SnapshotRequiresFrozenCatalogue) {
+    const TransportCatalogue catalogue;
+    std::ostringstream output;
+    ASSERT_THROWS(catalogue::WriteSnapshot(catalogue, output), std::logic_error);
+}
+
+TEST(SnapshotRejectsTruncatedFile) {
+    const std::string bytes = WriteToString(MakeCatalogue());
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        ASSERT_THROWS(LoadFromString(bytes.substr(0, size)), std::runtime_error);
+    }
+    ASSERT_THROWS(LoadFromString(bytes + '\0'), std::runtime_error);
+}
+
+TEST(SnapshotRejectsForeignFile) {
+    std::string bytes = WriteToString(MakeCatalogue());
+    bytes[0] = 'X';
+    ASSERT_THROWS(LoadFromString(bytes), std::runtime_error);
+    bytes = WriteToString(MakeCatalogue());
+    WriteU32(bytes, 8, catalogue::SNAPSHOT_VERSION + 1);
+    ASSERT_THROWS(LoadFromString(bytes), std::runtime_error);
+}
+
+// Конец файла при одном маршруте: размер хеша (1), seed, число корзин (1),
+// смещение единственной корзины и номер маршрута. Перед ним - номера остановок по хешу
+TEST(SnapshotRejectsCorruptedNameIndex) {
+    const std::string bytes = WriteToString(MakeCatalogue(true));
+    const size_t bus_displacement = bytes.size() - 8;
+    ASSERT_EQUAL(ReadU32(bytes, bus_displacement), catalogue::PerfectHash::DIRECT_SLOT);
+
+    std::string corrupted = bytes;
+    WriteU32(corrupted, bus_displacement, catalogue::PerfectHash::DIRECT_SLOT | 5);
+    ASSERT_THROWS(LoadFromString(corrupted), std::runtime_error);
+
+    // Номера двух остановок переставлены: каждая запись цела, но имя не на своём месте
+    corrupted = bytes;
+    const size_t stop_ids = bytes.size() - 24 - 4 * 4;
+    WriteU32(corrupted, stop_ids, ReadU32(bytes, stop_ids + 4));
+    WriteU32(corrupted, stop_ids + 4, ReadU32(bytes, stop_ids));
+    ASSERT_THROWS(LoadFromString(corrupted), std::runtime_error);
+}
+
+// Любой испорченный байт либо отвергается, либо даёт справочник, который можно читать
+TEST(SnapshotSurvivesCorruptedBytes) {
+    const TransportCatalogue catalogue = MakeCatalogue();
+    const std::string bytes = WriteToString(catalogue);
+    for (size_t pos = 0; pos < bytes.size(); ++pos) {
+        for (const unsigned char mask : {0x01, 0x80, 0xFF}) {
+            std::string corrupted = bytes;
+            corrupted[pos] = static_cast<char>(corrupted[pos] ^ mask);
+            try {
+                const TransportCatalogue loaded = LoadFromString(corrupted);
+                for (const auto& [name, bus] : catalogue.GetAllBuses()) {
+                    if (const auto it = loaded.GetAllBuses().find(name); it != loaded.GetAllBuses().end()) {
+                        loaded.GetRouteInfo(name);
+                        loaded.GetRoadDistanceOnRoute(it->second, 0, it->second->GetRoute().size() - 1);
+                    }
+                }
+                for (const auto& [name, stop] : catalogue.GetAllStops()) {
+                    if (loaded.GetStopByName(name).has_value()) {
+                        loaded.GetStopInfo(name);
+                    }
+                }
+            } catch (const std::runtime_error&) {
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Минимальный набор для тестов без внешних зависимостей. TEST(Name) регистрирует тест,
+// ASSERT* прерывает его исключением с файлом и строкой проверки; тесты запускает tests/main.cpp
+namespace testing {
+
+struct TestCase {
+    const char* name;
+    void (*func)();
+};
+
+inline std::vector<TestCase>& GetTests() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*func)()) {
+        GetTests().push_back({name, func});
+    }
+};
+
+class AssertionError : public std::runtime_error {
+public:
+    AssertionError(const char* file, int line, const std::string& message)
+        : std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": " + message) {
+    }
+};
+
+}  // namespace testing
+
+#define TEST(name)                                                  \
+    static void name();                                             \
+    static const testing::Registrar name##_registrar(#name, name);  \
+    static void name()
+
+#define ASSERT(expr)                                                \
+    do {                                                            \
+        if (!(expr)) {                                              \
+            throw testing::AssertionError(__FILE__, __LINE__, #expr); \
+        }                                                           \
+    } while (false)
+
+#define ASSERT_EQUAL(lhs, rhs) ASSERT((lhs) == (rhs))
+
+// Выражение должно выбросить исключение типа exception (или производного)
+#define ASSERT_THROWS(expr, exception)                              \
+    do {                                                            \
+        bool thrown = false;                                        \
+        try {                                                       \
+            static_cast<void>(expr);                                \
+        } catch (const exception&) {                                \
+            thrown = true;                                          \
+        }                                                           \
+        if (!thrown) {                                              \
+            throw testing::AssertionError(__FILE__, __LINE__, #expr " does not throw " #exception); \
+        }                                                           \
+    } while (false)
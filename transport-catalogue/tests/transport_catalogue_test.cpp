@@ -0,0 +1,53 @@
+#include <stdexcept>
+
+#include "../transport_catalogue.h"
+#include "test_framework.h"
+
+using catalogue::TransportCatalogue;
+
+namespace {
+
+catalogue::Bus MakeBus(const TransportCatalogue& catalogue, std::string_view name, std::vector<std::string_view> stops) {
+    catalogue::Bus bus;
+    bus.name = name;
+    for (const std::string_view stop : stops) {
+        bus.stops.push_back(catalogue.GetStopByName(stop).value());
+    }
+    return bus;
+}
+
+}  // namespace
+
+// Маршрут с неизвестной остановкой отвергается до изменений: справочник остаётся прежним
+TEST(FailedFreezeLeavesCatalogueUsable) {
+    TransportCatalogue catalogue;
+    catalogue.AddStop("A", {55.611087, 37.20829});
+    catalogue.AddStop("B", {55.595884, 37.209755});
+    catalogue.AddStopsDistance(catalogue.GetStopByName("A").value(), catalogue.GetStopByName("B").value(), 3900);
+    catalogue.AddBus(MakeBus(catalogue, "X", {"A", "B"}));
+
+    TransportCatalogue::BulkData data;
+    data.stops = {{"C", {55.632761, 37.333324}}};
+    data.buses = {{"Y", {"A", "C"}, false}, {"W", {"B", "Q"}, false}};
+    catalogue.Load(std::move(data));
+    ASSERT_THROWS(catalogue.Freeze(), std::out_of_range);
+    ASSERT(!catalogue.IsFrozen());
+    ASSERT(!catalogue.GetStopByName("C").has_value());
+    ASSERT_EQUAL(catalogue.GetAllBuses().size(), 1u);
+
+    catalogue.AddBus(MakeBus(catalogue, "Z", {"B", "A"}));
+    ASSERT_EQUAL(catalogue.GetRouteInfo("Z").lenght, 2 * 3900u);
+    ASSERT_EQUAL(catalogue.GetRouteInfo("X").lenght, 2 * 3900u);
+    ASSERT_EQUAL(catalogue.GetRoadDistanceOnRoute(catalogue.GetAllBuses().at("Z"), 0, 2), 2 * 3900u);
+
+    // Отвергнутые записи отброшены, следующая загрузка проходит
+    data = {};
+    data.stops = {{"C", {55.632761, 37.333324}}};
+    data.buses = {{"Y", {"A", "C"}, false}};
+    catalogue.Load(std::move(data));
+    catalogue.Freeze();
+    ASSERT(catalogue.IsFrozen());
+    ASSERT_EQUAL(catalogue.GetAllBuses().size(), 3u);
+    ASSERT_EQUAL(catalogue.GetStopInfo("C").size(), 1u);
+    ASSERT_EQUAL(catalogue.GetRouteInfo("Y").count_stops, 3u);
+}
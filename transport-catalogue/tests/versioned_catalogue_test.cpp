@@ -0,0 +1,122 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../versioned_catalogue.h"
+#include "test_framework.h"
+
+using catalogue::TransportCatalogue;
+using catalogue::VersionedCatalogue;
+using Action = TransportCatalogue::DeltaAction;
+
+namespace {
+
+TransportCatalogue MakeCatalogue() {
+    TransportCatalogue::BulkData data;
+    data.stops = {{"A", {55.611087, 37.20829}},
+                  {"B", {55.595884, 37.209755}},
+                  {"C", {55.632761, 37.333324}}};
+    data.distances = {{"A", "B", 3900}, {"B", "C", 9900}};
+    data.buses = {{"X", {"A", "B", "C"}, false}};
+    TransportCatalogue catalogue;
+    catalogue.Load(std::move(data));
+    catalogue.Freeze();
+    return catalogue;
+}
+
+// Меняет расстояние A -> B, а с ним и длину маршрута X
+void SetDistance(TransportCatalogue& catalogue, unsigned int dist) {
+    TransportCatalogue::DeltaData delta;
+    delta.distances = {{Action::REPLACE, {"A", "B", dist}}};
+    catalogue.ApplyDelta(delta);
+}
+
+}  // namespace
+
+TEST(VersionedCatalogueKeepsPinnedVersion) {
+    VersionedCatalogue versions(MakeCatalogue());
+    const unsigned int initial_length = versions.Read()->GetRouteInfo("X").lenght;
+    {
+        const auto pinned = versions.Read();
+        ASSERT_EQUAL(pinned.GetVersion(), 1u);
+        ASSERT_EQUAL(versions.Update([](TransportCatalogue& next) { SetDistance(next, 100); }), 2u);
+        ASSERT_EQUAL(versions.Update([](TransportCatalogue& next) { SetDistance(next, 200); }), 3u);
+        // Обе заменённые версии ждут, пока pinned их читает
+        ASSERT_EQUAL(versions.Reclaim(), 2u);
+        ASSERT_EQUAL(pinned.GetVersion(), 1u);
+        ASSERT_EQUAL(pinned->GetRouteInfo("X").lenght, initial_length);
+
+        const auto latest = versions.Read();
+        ASSERT_EQUAL(latest.GetVersion(), 3u);
+        ASSERT_EQUAL(latest->GetRouteInfo("X").lenght, 2 * 9900u + 200 + 200);
+    }
+    ASSERT_EQUAL(versions.Reclaim(), 0u);
+    ASSERT_EQUAL(versions.Read().GetVersion(), 3u);
+}
+
+// Читатель держит только версии, заменённые после того, как он начал чтение
+TEST(VersionedCatalogueReclaimsVersionsOlderThanReaders) {
+    VersionedCatalogue versions(MakeCatalogue());
+    versions.Update([](TransportCatalogue& next) { SetDistance(next, 100); });
+    const auto pinned = versions.Read();
+    ASSERT_EQUAL(pinned.GetVersion(), 2u);
+    ASSERT_EQUAL(versions.Reclaim(), 0u);
+    versions.Update([](TransportCatalogue& next) { SetDistance(next, 200); });
+    ASSERT_EQUAL(versions.Reclaim(), 1u);
+    ASSERT_EQUAL(pinned->GetRouteInfo("X").lenght, 2 * 9900u + 100 + 100);
+}
+
+TEST(VersionedCatalogueFailedUpdatePublishesNothing) {
+    VersionedCatalogue versions(MakeCatalogue());
+    ASSERT_THROWS(versions.Update([](TransportCatalogue& next) {
+        SetDistance(next, 100);
+        TransportCatalogue::DeltaData delta;
+        delta.stops = {{Action::REMOVE, {"Q", {}}}};
+        next.ApplyDelta(delta);
+    }), std::out_of_range);
+    const auto current = versions.Read();
+    ASSERT_EQUAL(current.GetVersion(), 1u);
+    ASSERT_EQUAL(current->GetStopsDistance(current->GetStopByName("A").value(), current->GetStopByName("B").value()), 3900u);
+    ASSERT_EQUAL(versions.Reclaim(), 0u);
+}
+
+TEST(VersionedCatalogueRejectsInvalidUse) {
+    ASSERT_THROWS(VersionedCatalogue(TransportCatalogue()), std::logic_error);
+    VersionedCatalogue versions(MakeCatalogue(), 2);
+    ASSERT_THROWS(versions.Publish(TransportCatalogue()), std::logic_error);
+    const auto first = versions.Read();
+    const auto second = versions.Read();
+    ASSERT_THROWS(versions.Read(), std::length_error);
+}
+
+// Читатели не видят промежуточных состояний: длина маршрута всегда из одной версии
+TEST(VersionedCatalogueConcurrentReaders) {
+    VersionedCatalogue versions(MakeCatalogue());
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                const auto version = versions.Read();
+                const auto& catalogue = *version;
+                const unsigned int dist = catalogue.GetStopsDistance(catalogue.GetStopByName("A").value(),
+                                                                     catalogue.GetStopByName("B").value());
+                if (catalogue.GetRouteInfo("X").lenght != 2 * 9900 + 2 * dist) {
+                    consistent = false;
+                }
+            }
+        });
+    }
+    for (unsigned int dist = 1; dist <= 200; ++dist) {
+        versions.Update([dist](TransportCatalogue& next) { SetDistance(next, dist); });
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    ASSERT(consistent.load());
+    ASSERT_EQUAL(versions.Reclaim(), 0u);
+    ASSERT_EQUAL(versions.Read().GetVersion(), 201u);
+}
@@ -1,26 +1,77 @@
 #include "transport_catalogue.h"
+#include "parallel.h"
+
+#include <stdexcept>
+#include <tuple>
 
 namespace catalogue {
 
+namespace {
+
+// Меньше стольких записей на поток параллельная обработка не окупается
+constexpr size_t MIN_RECORDS_PER_WORKER = 1024;
+
+// Раскладывает элементы по группам: элементы группы g - items[offsets[g], offsets[g + 1]),
+// в исходном порядке
+template <typename T, typename GroupOf>
+std::vector<size_t> GroupBy(std::vector<T>& items, size_t group_count, GroupOf group_of){
+    std::vector<size_t> offsets(group_count + 1, 0);
+    for(const T& item : items){
+        ++offsets[group_of(item) + 1];
+    }
+    for(size_t group = 0; group < group_count; ++group){
+        offsets[group + 1] += offsets[group];
+    }
+    std::vector<T> grouped(items.size());
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for(T& item : items){
+        grouped[next[group_of(item)]++] = std::move(item);
+    }
+    items = std::move(grouped);
+    return offsets;
+}
+
+}  // namespace
+
 void TransportCatalogue::AddStop(std::string_view name, geo::Coordinates coord){
-    stops_.emplace_back(Stop{std::string(name), std::move(coord)});
+    CheckNotFrozen();
+    const std::string_view stored_name = names_.GetString(names_.Intern(name));
+    stops_.emplace_back(Stop{stored_name, geo::ToStoredCoordinates(coord), static_cast<uint32_t>(stops_.size())});
+    road_distances_.emplace_back(GetAllocator<RoadDistance>());
+    prepared_coords_.PushBack(geo::Prepare(geo::ToCoordinates(stops_.back().coord)));
 
-    const std::string* tmp_name = &stops_.back().name;
-    stop_ptrs_[*tmp_name] = &stops_.back();
+    stop_ptrs_[stored_name] = &stops_.back();
         
-    if (buses_on_stop_.count(*tmp_name) == 0) {
-        buses_on_stop_[*tmp_name] = {};
-    }
+    buses_on_stop_.try_emplace(stored_name, GetAllocator<std::string_view>());
 }
 
 void TransportCatalogue::AddStopsDistance(const Stop* from_stop, const Stop* to_stop, unsigned int dist){
-    dist_between_stops_[{from_stop, to_stop}] = dist;
+    CheckNotFrozen();
+    SetAdjacent(road_distances_.at(from_stop->id), to_stop->id, dist, true);
+    SetAdjacent(road_distances_.at(to_stop->id), from_stop->id, dist, false);
+}
+
+void TransportCatalogue::SetAdjacent(AdjacentStops& adjacent, uint32_t to, unsigned int dist, bool is_direct){
+    auto it = adjacent.begin() + (FindAdjacent(adjacent, to) - adjacent.cbegin());
+    if(it == adjacent.end() || it->to != to){
+        adjacent.insert(it, RoadDistance{to, dist, is_direct});
+    }else if(is_direct || !it->is_direct){
+        // обратное направление не перезаписывает явно заданное расстояние
+        it->dist = dist;
+        it->is_direct = is_direct;
+    }
 }
 
 void TransportCatalogue::AddBus(Bus bus){
+    CheckNotFrozen();
+    bus.id = static_cast<uint32_t>(buses_.size());
+    bus.name = names_.GetString(names_.Intern(bus.name));
+    // Маршрут собран вне справочника, его остановки переносятся в арену
+    bus.stops = StopSequence(bus.stops.begin(), bus.stops.end(), GetAllocator<const Stop*>());
     buses_.emplace_back(std::move(bus));
     
     const auto& last_added_bus = buses_.back();
+    bus_lengths_.push_back(ComputeRouteLengths(&last_added_bus));
     for(const auto& stop : last_added_bus.stops){
         buses_on_stop_[stop->name].insert(last_added_bus.name);
     }
@@ -28,21 +79,569 @@ void TransportCatalogue::AddBus(Bus bus){
     bus_ptrs_[last_added_bus.name] = &last_added_bus;
 }
 
+void TransportCatalogue::Load(BulkData data){
+    CheckNotFrozen();
+    const auto append = [](auto& to, auto& from){
+        if(to.empty()){
+            to = std::move(from);
+        }else{
+            to.insert(to.end(), std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()));
+        }
+    };
+    append(bulk_.stops, data.stops);
+    append(bulk_.distances, data.distances);
+    append(bulk_.buses, data.buses);
+}
+
+void TransportCatalogue::Freeze(){
+    CheckNotFrozen();
+    const BulkData data = std::move(bulk_);
+    bulk_ = {};
+    // Все проверки - до первого изменения: при ошибке справочник остаётся прежним
+    CheckBusStops(data);
+    const size_t first_bus = buses_.size();
+
+    // Каждый шаг зависит только от предыдущих, независимые индексы строятся одновременно
+    FreezeStops(data.stops);
+    parallel::Invoke([&]{ FreezeDistances(data.distances); },
+                     [&]{ FreezeBuses(data.buses); });
+    parallel::Invoke([&]{
+                         bus_lengths_.resize(buses_.size());
+                         parallel::For(buses_.size() - first_bus, MIN_RECORDS_PER_WORKER / 16, [&](size_t begin, size_t end){
+                             for(size_t i = first_bus + begin; i < first_bus + end; ++i){
+                                 bus_lengths_[i] = ComputeRouteLengths(&buses_[i]);
+                             }
+                         });
+                     },
+                     [&]{ FreezeBusesOnStops(first_bus); },
+                     [&]{ FreezeStopIndex(); },
+                     [&]{ FreezeBusIndex(); });
+    frozen_ = true;
+}
+
+TransportCatalogue TransportCatalogue::Clone() const{
+    TransportCatalogue result;
+    result.names_ = names_.Share();
+    result.stops_ = stops_;
+    // Копии контейнеров создаются в арене копии, а не в куче
+    for(const Bus& bus : buses_){
+        Bus& copy = result.buses_.emplace_back(Bus{bus.name, bus.is_roundtrip, StopSequence(result.GetAllocator<const Stop*>()), bus.id});
+        copy.stops.reserve(bus.stops.size());
+        for(const Stop* stop : bus.stops){
+            copy.stops.push_back(&result.stops_[stop->id]);
+        }
+    }
+    // Копия unordered_map сохраняет порядок обхода, поэтому ответы копии совпадают с исходными
+    result.stop_ptrs_ = stop_ptrs_;
+    for(auto& [name, stop] : result.stop_ptrs_){
+        stop = &result.stops_[stop->id];
+    }
+    result.bus_ptrs_ = bus_ptrs_;
+    for(auto& [name, bus] : result.bus_ptrs_){
+        bus = &result.buses_[bus->id];
+    }
+    result.buses_on_stop_ = buses_on_stop_;
+    for(auto& [name, buses] : result.buses_on_stop_){
+        buses = BusNames(buses, result.GetAllocator<std::string_view>());
+    }
+    result.prepared_coords_ = prepared_coords_;
+    result.road_distances_.reserve(road_distances_.size());
+    for(const AdjacentStops& adjacent : road_distances_){
+        result.road_distances_.emplace_back(adjacent, result.GetAllocator<RoadDistance>());
+    }
+    result.bus_lengths_.reserve(bus_lengths_.size());
+    for(const BusRouteLengths& lengths : bus_lengths_){
+        BusRouteLengths& copy = result.bus_lengths_.emplace_back(result.MakeRouteLengths(0));
+        copy.road.assign(lengths.road.begin(), lengths.road.end());
+        copy.geo.assign(lengths.geo.begin(), lengths.geo.end());
+        copy.info = lengths.info;
+    }
+    result.bulk_ = bulk_;
+    result.frozen_ = frozen_;
+
+    result.name_index_partial_ = name_index_partial_;
+    result.stop_hash_ = stop_hash_;
+    result.stop_slots_ = stop_slots_;
+    for(StopSlot& slot : result.stop_slots_){
+        if(slot.stop != nullptr){
+            slot.stop = &result.stops_[slot.stop->id];
+            slot.buses = &result.buses_on_stop_.find(slot.name)->second;
+        }else{
+            slot.buses = nullptr;
+        }
+    }
+    result.bus_hash_ = bus_hash_;
+    result.bus_slots_ = bus_slots_;
+    for(BusSlot& slot : result.bus_slots_){
+        if(slot.bus != nullptr){
+            slot.bus = &result.buses_[slot.bus->id];
+        }
+    }
+    return result;
+}
+
+void TransportCatalogue::CheckNotFrozen() const{
+    if(frozen_){
+        throw std::logic_error("Catalogue is frozen");
+    }
+}
+
+void TransportCatalogue::CheckBusStops(const BulkData& data) const{
+    std::unordered_set<std::string_view> new_stops;
+    new_stops.reserve(data.stops.size());
+    for(const StopRecord& stop : data.stops){
+        new_stops.insert(stop.name);
+    }
+    parallel::For(data.buses.size(), MIN_RECORDS_PER_WORKER / 16, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; ++i){
+            for(const std::string_view stop : data.buses[i].stops){
+                if(new_stops.count(stop) == 0 && stop_ptrs_.count(stop) == 0){
+                    throw std::out_of_range("Unknown stop '" + std::string(stop) + "'");
+                }
+            }
+        }
+    });
+}
+
+void TransportCatalogue::FreezeStops(const std::vector<StopRecord>& stops){
+    const size_t first_stop = stops_.size();
+    const size_t stop_count = first_stop + stops.size();
+    stops_.resize(stop_count);
+    road_distances_.reserve(stop_count);
+    while(road_distances_.size() < stop_count){
+        road_distances_.emplace_back(GetAllocator<RoadDistance>());
+    }
+    prepared_coords_.Resize(stop_count);
+    names_.Reserve(names_.GetSize() + stops.size());
+    for(size_t i = 0; i < stops.size(); ++i){
+        stops_[first_stop + i].name = names_.GetString(names_.Intern(stops[i].name));
+    }
+    parallel::For(stops.size(), MIN_RECORDS_PER_WORKER, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; ++i){
+            Stop& stop = stops_[first_stop + i];
+            stop.coord = geo::ToStoredCoordinates(stops[i].coord);
+            stop.id = static_cast<uint32_t>(first_stop + i);
+            prepared_coords_.Set(stop.id, geo::Prepare(geo::ToCoordinates(stop.coord)));
+        }
+    });
+
+    // При повторяющихся именах побеждает последняя остановка, как в AddStop
+    parallel::Invoke([&]{
+                         stop_ptrs_.reserve(stop_count);
+                         for(size_t i = first_stop; i < stop_count; ++i){
+                             stop_ptrs_[stops_[i].name] = &stops_[i];
+                         }
+                     },
+                     [&]{
+                         buses_on_stop_.reserve(stop_count);
+                         for(size_t i = first_stop; i < stop_count; ++i){
+                             buses_on_stop_.try_emplace(stops_[i].name, GetAllocator<std::string_view>());
+                         }
+                     });
+}
+
+// Результат совпадает с AddStopsDistance по порядку записей: для каждой пары остановок
+// побеждает последнее прямое расстояние, а без прямых - последнее обратное
+void TransportCatalogue::FreezeDistances(const std::vector<DistanceRecord>& distances){
+    struct Candidate {
+        uint32_t from = 0;
+        RoadDistance distance{};
+        // Номер записи, начиная с 1; у уже известных расстояний - 0
+        size_t order = 0;
+    };
+    constexpr uint32_t UNKNOWN_STOP = UINT32_MAX;
+
+    std::vector<Candidate> candidates(distances.size() * 2);
+    parallel::For(distances.size(), MIN_RECORDS_PER_WORKER, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; ++i){
+            const auto from = stop_ptrs_.find(distances[i].from);
+            const auto to = stop_ptrs_.find(distances[i].to);
+            if(from == stop_ptrs_.end() || to == stop_ptrs_.end()){
+                candidates[2 * i].from = candidates[2 * i + 1].from = UNKNOWN_STOP;
+                continue;
+            }
+            const uint32_t from_id = from->second->id;
+            const uint32_t to_id = to->second->id;
+            candidates[2 * i] = {from_id, {to_id, distances[i].dist, true}, i + 1};
+            candidates[2 * i + 1] = {to_id, {from_id, distances[i].dist, false}, i + 1};
+        }
+    });
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const Candidate& candidate){
+        return candidate.from == UNKNOWN_STOP;
+    }), candidates.end());
+
+    const size_t stop_count = stops_.size();
+    const auto offsets = GroupBy(candidates, stop_count, [](const Candidate& candidate){
+        return candidate.from;
+    });
+    parallel::For(stop_count, MIN_RECORDS_PER_WORKER, [&](size_t begin, size_t end){
+        std::vector<Candidate> stop_candidates;
+        for(size_t stop = begin; stop < end; ++stop){
+            if(offsets[stop] == offsets[stop + 1]){
+                continue;
+            }
+            AdjacentStops& adjacent = road_distances_[stop];
+            stop_candidates.clear();
+            for(const RoadDistance& known : adjacent){
+                stop_candidates.push_back({static_cast<uint32_t>(stop), known, 0});
+            }
+            stop_candidates.insert(stop_candidates.end(), candidates.begin() + offsets[stop], candidates.begin() + offsets[stop + 1]);
+            // Победитель для каждой остановки назначения оказывается последним в своей группе
+            std::sort(stop_candidates.begin(), stop_candidates.end(), [](const Candidate& lhs, const Candidate& rhs){
+                return std::tie(lhs.distance.to, lhs.distance.is_direct, lhs.order)
+                     < std::tie(rhs.distance.to, rhs.distance.is_direct, rhs.order);
+            });
+            adjacent.clear();
+            for(size_t i = 0; i < stop_candidates.size(); ++i){
+                if(i + 1 == stop_candidates.size() || stop_candidates[i + 1].distance.to != stop_candidates[i].distance.to){
+                    adjacent.push_back(stop_candidates[i].distance);
+                }
+            }
+        }
+    });
+}
+
+void TransportCatalogue::FreezeBuses(const std::vector<BusRecord>& buses){
+    const size_t first_bus = buses_.size();
+    buses_.resize(first_bus + buses.size());
+    for(size_t i = 0; i < buses.size(); ++i){
+        buses_[first_bus + i].name = names_.GetString(names_.Intern(buses[i].name));
+        buses_[first_bus + i].stops = StopSequence(GetAllocator<const Stop*>());
+    }
+    parallel::For(buses.size(), MIN_RECORDS_PER_WORKER / 16, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; ++i){
+            Bus& bus = buses_[first_bus + i];
+            bus.is_roundtrip = buses[i].is_roundtrip;
+            bus.id = static_cast<uint32_t>(first_bus + i);
+            bus.stops.reserve(buses[i].stops.size());
+            for(const std::string_view stop : buses[i].stops){
+                bus.stops.push_back(stop_ptrs_.at(stop));
+            }
+        }
+    });
+
+    bus_ptrs_.reserve(buses_.size());
+    for(size_t i = first_bus; i < buses_.size(); ++i){
+        bus_ptrs_[buses_[i].name] = &buses_[i];
+    }
+}
+
+// Маршруты раскладываются по остановкам, после чего множества остановок заполняются
+// параллельно. Остановки маршрутов найдены по имени, поэтому у каждого имени одна остановка
+// и потоки не делят множества
+void TransportCatalogue::FreezeBusesOnStops(size_t first_bus){
+    struct Visit {
+        uint32_t stop;
+        std::string_view bus;
+    };
+    std::vector<Visit> visits;
+    for(size_t i = first_bus; i < buses_.size(); ++i){
+        for(const Stop* stop : buses_[i].stops){
+            visits.push_back({stop->id, buses_[i].name});
+        }
+    }
+    const auto offsets = GroupBy(visits, stops_.size(), [](const Visit& visit){
+        return visit.stop;
+    });
+    parallel::For(stops_.size(), MIN_RECORDS_PER_WORKER, [&](size_t begin, size_t end){
+        std::vector<std::string_view> names;
+        for(size_t stop = begin; stop < end; ++stop){
+            if(offsets[stop] == offsets[stop + 1]){
+                continue;
+            }
+            names.clear();
+            for(size_t i = offsets[stop]; i < offsets[stop + 1]; ++i){
+                names.push_back(visits[i].bus);
+            }
+            // Отсортированные имена вставляются в std::set за линейное время
+            std::sort(names.begin(), names.end());
+            auto& buses = buses_on_stop_.find(stops_[stop].name)->second;
+            buses.insert(names.begin(), names.end());
+        }
+    });
+}
+
+// Записи раскладываются по номерам совершенного хеша; множества маршрутов
+// в это время может заполнять FreezeBusesOnStops, но их адреса не меняются
+void TransportCatalogue::FreezeStopIndex(){
+    std::vector<std::string_view> names;
+    names.reserve(stop_ptrs_.size());
+    for(const auto& [name, stop] : stop_ptrs_){
+        names.push_back(name);
+    }
+    stop_hash_ = PerfectHash(names);
+    stop_slots_.assign(names.size(), {});
+    for(const auto& [name, stop] : stop_ptrs_){
+        stop_slots_[stop_hash_(name)] = {name, stop, &buses_on_stop_.find(name)->second};
+    }
+}
+
+void TransportCatalogue::FreezeBusIndex(){
+    std::vector<std::string_view> names;
+    names.reserve(bus_ptrs_.size());
+    for(const auto& [name, bus] : bus_ptrs_){
+        names.push_back(name);
+    }
+    bus_hash_ = PerfectHash(names);
+    bus_slots_.assign(names.size(), {});
+    for(const auto& [name, bus] : bus_ptrs_){
+        bus_slots_[bus_hash_(name)] = {name, bus};
+    }
+}
+
+void TransportCatalogue::ApplyDelta(const DeltaData& delta){
+    if(!frozen_){
+        throw std::logic_error("Delta can be applied only to a frozen catalogue");
+    }
+    std::vector<uint32_t> dirty_buses;
+    // Каждая запись проверяется до того, как что-то поменять, поэтому ошибка оставляет в силе
+    // все записи до неё. Маршруты, затронутые ими, пересчитываются и в этом случае
+    const auto update_bus_lengths = [this, &dirty_buses](){
+        std::sort(dirty_buses.begin(), dirty_buses.end());
+        dirty_buses.erase(std::unique(dirty_buses.begin(), dirty_buses.end()), dirty_buses.end());
+        parallel::For(dirty_buses.size(), MIN_RECORDS_PER_WORKER / 16, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                bus_lengths_[dirty_buses[i]] = ComputeRouteLengths(&buses_[dirty_buses[i]]);
+            }
+        });
+    };
+    try{
+        for(const auto& [action, bus] : delta.buses){
+            if(action == DeltaAction::REMOVE){
+                DeltaRemoveBus(bus.name);
+            }
+        }
+        for(const auto& [action, stop] : delta.stops){
+            if(action == DeltaAction::ADD){
+                DeltaAddStop(stop);
+            }else if(action == DeltaAction::REPLACE){
+                DeltaReplaceStop(stop, dirty_buses);
+            }
+        }
+        for(const auto& [action, distance] : delta.distances){
+            if(action == DeltaAction::REMOVE){
+                DeltaRemoveDistance(distance, dirty_buses);
+            }else{
+                DeltaSetDistance(distance, dirty_buses);
+            }
+        }
+        for(const auto& [action, bus] : delta.buses){
+            if(action == DeltaAction::ADD){
+                DeltaAddBus(bus, dirty_buses);
+            }else if(action == DeltaAction::REPLACE){
+                DeltaReplaceBus(bus, dirty_buses);
+            }
+        }
+        for(const auto& [action, stop] : delta.stops){
+            if(action == DeltaAction::REMOVE){
+                DeltaRemoveStop(stop.name);
+            }
+        }
+    }catch(...){
+        update_bus_lengths();
+        throw;
+    }
+    update_bus_lengths();
+
+    // Копия стоит столько, сколько занято, а освобождено к этому времени больше, так что
+    // сжатие окупается, а после ApplyDelta() в арене освобождено не больше, чем занято
+    const ArenaStats stats = GetArenaStats();
+    if(stats.freed_bytes >= MIN_ARENA_WASTE_TO_COMPACT && stats.freed_bytes > stats.allocated_bytes - stats.freed_bytes){
+        *this = Clone();
+    }
+}
+
+const Stop* TransportCatalogue::FindLiveStop(std::string_view name) const{
+    if(const auto it = stop_ptrs_.find(name); it != stop_ptrs_.end()){
+        return it->second;
+    }
+    throw std::out_of_range("Unknown stop '" + std::string(name) + "'");
+}
+
+Bus* TransportCatalogue::FindLiveBus(std::string_view name){
+    if(const auto it = bus_ptrs_.find(name); it != bus_ptrs_.end()){
+        return &buses_[it->second->id];
+    }
+    throw std::out_of_range("Unknown bus '" + std::string(name) + "'");
+}
+
+void TransportCatalogue::MarkBusesThrough(const Stop* stop, std::vector<uint32_t>& dirty_buses) const{
+    for(const std::string_view bus : buses_on_stop_.at(stop->name)){
+        dirty_buses.push_back(bus_ptrs_.at(bus)->id);
+    }
+}
+
+// Участок между остановками может быть только у маршрутов, проходящих через обе
+void TransportCatalogue::MarkBusesBetween(const Stop* from, const Stop* to, std::vector<uint32_t>& dirty_buses) const{
+    const auto& to_buses = buses_on_stop_.at(to->name);
+    for(const std::string_view bus : buses_on_stop_.at(from->name)){
+        if(to_buses.count(bus) > 0){
+            dirty_buses.push_back(bus_ptrs_.at(bus)->id);
+        }
+    }
+}
+
+void TransportCatalogue::DeltaAddStop(const StopRecord& record){
+    if(stop_ptrs_.count(record.name) > 0){
+        throw std::invalid_argument("Stop '" + std::string(record.name) + "' already exists");
+    }
+    const std::string_view name = names_.GetString(names_.Intern(record.name));
+    Stop& stop = stops_.emplace_back(Stop{name, geo::ToStoredCoordinates(record.coord), static_cast<uint32_t>(stops_.size())});
+    road_distances_.emplace_back(GetAllocator<RoadDistance>());
+    prepared_coords_.PushBack(geo::Prepare(geo::ToCoordinates(stop.coord)));
+    stop_ptrs_.emplace(name, &stop);
+    buses_on_stop_.try_emplace(name, GetAllocator<std::string_view>());
+    name_index_partial_ = true;
+}
+
+void TransportCatalogue::DeltaReplaceStop(const StopRecord& record, std::vector<uint32_t>& dirty_buses){
+    Stop& stop = stops_[FindLiveStop(record.name)->id];
+    stop.coord = geo::ToStoredCoordinates(record.coord);
+    prepared_coords_.Set(stop.id, geo::Prepare(geo::ToCoordinates(stop.coord)));
+    MarkBusesThrough(&stop, dirty_buses);
+}
+
+void TransportCatalogue::DeltaRemoveStop(std::string_view name){
+    const Stop* stop = FindLiveStop(name);
+    const auto buses = buses_on_stop_.find(stop->name);
+    if(!buses->second.empty()){
+        throw std::invalid_argument("Stop '" + std::string(name) + "' is used by buses");
+    }
+    // Маршрутов через остановку нет, поэтому её расстояния не входят ни в одну статистику
+    for(const RoadDistance& distance : road_distances_[stop->id]){
+        if(distance.to == stop->id){
+            continue;
+        }
+        AdjacentStops& adjacent = road_distances_[distance.to];
+        adjacent.erase(adjacent.begin() + (FindAdjacent(adjacent, stop->id) - adjacent.cbegin()));
+    }
+    road_distances_[stop->id].clear();
+
+    if(!stop_slots_.empty()){
+        if(StopSlot& slot = stop_slots_[stop_hash_(stop->name)]; slot.stop == stop){
+            slot.stop = nullptr;
+        }
+    }
+    name_index_partial_ = true;
+    buses_on_stop_.erase(buses);
+    stop_ptrs_.erase(stop->name);
+}
+
+void TransportCatalogue::DeltaSetDistance(const DistanceRecord& record, std::vector<uint32_t>& dirty_buses){
+    const Stop* from = FindLiveStop(record.from);
+    const Stop* to = FindLiveStop(record.to);
+    SetAdjacent(road_distances_[from->id], to->id, record.dist, true);
+    SetAdjacent(road_distances_[to->id], from->id, record.dist, false);
+    MarkBusesBetween(from, to, dirty_buses);
+}
+
+// Без прямого расстояния участок from -> to берёт обратное to -> from, если оно задано
+void TransportCatalogue::DeltaRemoveDistance(const DistanceRecord& record, std::vector<uint32_t>& dirty_buses){
+    const Stop* from = FindLiveStop(record.from);
+    const Stop* to = FindLiveStop(record.to);
+    AdjacentStops& forward = road_distances_[from->id];
+    const auto forward_it = forward.begin() + (FindAdjacent(forward, to->id) - forward.cbegin());
+    if(forward_it == forward.end() || forward_it->to != to->id || !forward_it->is_direct){
+        throw std::invalid_argument("Unknown distance from '" + std::string(record.from) + "' to '" + std::string(record.to) + "'");
+    }
+    if(from == to){
+        forward.erase(forward_it);
+    }else{
+        AdjacentStops& backward = road_distances_[to->id];
+        const auto backward_it = backward.begin() + (FindAdjacent(backward, from->id) - backward.cbegin());
+        if(backward_it->is_direct){
+            forward_it->dist = backward_it->dist;
+            forward_it->is_direct = false;
+        }else{
+            forward.erase(forward_it);
+            backward.erase(backward_it);
+        }
+    }
+    MarkBusesBetween(from, to, dirty_buses);
+}
+
+StopSequence TransportCatalogue::ResolveRoute(const BusRecord& record) const{
+    StopSequence stops(GetAllocator<const Stop*>());
+    stops.reserve(record.stops.size());
+    for(const std::string_view stop : record.stops){
+        stops.push_back(FindLiveStop(stop));
+    }
+    return stops;
+}
+
+void TransportCatalogue::DeltaAddBus(const BusRecord& record, std::vector<uint32_t>& dirty_buses){
+    if(bus_ptrs_.count(record.name) > 0){
+        throw std::invalid_argument("Bus '" + std::string(record.name) + "' already exists");
+    }
+    StopSequence stops = ResolveRoute(record);
+    Bus& bus = buses_.emplace_back();
+    bus.name = names_.GetString(names_.Intern(record.name));
+    bus.is_roundtrip = record.is_roundtrip;
+    bus.stops = std::move(stops);
+    bus.id = static_cast<uint32_t>(buses_.size() - 1);
+    bus_lengths_.emplace_back();
+    for(const Stop* stop : bus.stops){
+        buses_on_stop_.at(stop->name).insert(bus.name);
+    }
+    bus_ptrs_.emplace(bus.name, &bus);
+    name_index_partial_ = true;
+    dirty_buses.push_back(bus.id);
+}
+
+void TransportCatalogue::DeltaReplaceBus(const BusRecord& record, std::vector<uint32_t>& dirty_buses){
+    Bus& bus = *FindLiveBus(record.name);
+    StopSequence stops = ResolveRoute(record);
+    for(const Stop* stop : bus.stops){
+        buses_on_stop_.at(stop->name).erase(bus.name);
+    }
+    bus.is_roundtrip = record.is_roundtrip;
+    bus.stops = std::move(stops);
+    for(const Stop* stop : bus.stops){
+        buses_on_stop_.at(stop->name).insert(bus.name);
+    }
+    dirty_buses.push_back(bus.id);
+}
+
+void TransportCatalogue::DeltaRemoveBus(std::string_view name){
+    Bus& bus = *FindLiveBus(name);
+    for(const Stop* stop : bus.stops){
+        buses_on_stop_.at(stop->name).erase(bus.name);
+    }
+    if(!bus_slots_.empty()){
+        if(BusSlot& slot = bus_slots_[bus_hash_(bus.name)]; slot.bus == &bus){
+            slot.bus = nullptr;
+        }
+    }
+    name_index_partial_ = true;
+    bus_ptrs_.erase(bus.name);
+}
+
 BusRoutInfo TransportCatalogue::GetRouteInfo(std::string_view name) const{
-    if(bus_ptrs_.count(name) > 0){
-        const Bus* bus = bus_ptrs_.at(name);
-        auto road_length = ComputeRoadRouteLength(bus);
-        return {static_cast<unsigned int>(bus->stops.size()),
-                CountUniqueStops(bus),
-                road_length,
-                road_length / ComputeGeographicalRouteLength(bus) };	
+    if(frozen_){
+        if(const BusSlot* slot = FindBusSlot(name)){
+            return bus_lengths_[slot->bus->id].info;
+        }
+        if(!name_index_partial_){
+            throw TransportCatalogueException();
+        }
+    }
+    if(const auto it = bus_ptrs_.find(name); it != bus_ptrs_.end()){
+        return bus_lengths_[it->second->id].info;
     }
     throw TransportCatalogueException();
 }
 
 std::set<std::string_view> TransportCatalogue::GetStopInfo(std::string_view stop_name) const{
+    if(frozen_){
+        if(const StopSlot* slot = FindStopSlot(stop_name)){
+            return {slot->buses->begin(), slot->buses->end()};
+        }
+        if(!name_index_partial_){
+            throw TransportCatalogueException();
+        }
+    }
     if(auto info = buses_on_stop_.find(stop_name); info != buses_on_stop_.end()){
-        return buses_on_stop_.at(stop_name);
+        return {info->second.begin(), info->second.end()};
     }
     throw TransportCatalogueException();
 }
@@ -55,32 +654,54 @@ unsigned int TransportCatalogue::CountUniqueStops(const Bus* bus) const {
     return static_cast<unsigned int>(unique_stops.size());
 }
 
-unsigned int TransportCatalogue::GetStopsDistance(const Stop* from_stop, const Stop* to_stop) const{
-    if(auto dist = dist_between_stops_.find({from_stop, to_stop}); dist != dist_between_stops_.end()){
-        return dist->second;
-    }else if (dist = dist_between_stops_.find({to_stop, from_stop}); dist != dist_between_stops_.end()){
-       return dist->second;
-    }
-    return 0;
+TransportCatalogue::BusRouteLengths TransportCatalogue::MakeRouteLengths(size_t point_count) const {
+    return {RoadLengths(point_count, GetAllocator<unsigned int>()),
+            GeoLengths(point_count, GetAllocator<double>()),
+            {}};
 }
 
-double TransportCatalogue::ComputeGeographicalRouteLength(const Bus* bus) const {
-    double rout_length = 0;
-    for (size_t i = 1; i < bus->stops.size(); ++i) {
-        rout_length += ComputeDistance(bus->stops[i - 1]->coord, bus->stops[i]->coord);
+TransportCatalogue::BusRouteLengths TransportCatalogue::ComputeRouteLengths(const Bus* bus) const {
+    const auto stops = bus->GetRoute();
+    BusRouteLengths lengths = MakeRouteLengths(stops.size());
+
+    if (stops.empty()) {
+        lengths.info = {0, 0, 0, 0};
+        return lengths;
     }
-    rout_length += ComputeDistance(bus->stops.back()->coord, bus->stops.front()->coord);
-    return rout_length;
-} 
 
-unsigned int TransportCatalogue::ComputeRoadRouteLength(const Bus* bus) const {
-    unsigned int rout_length = 0;
-    for (size_t i = 1; i < bus->stops.size(); ++i) {
-        rout_length += GetStopsDistance(bus->stops[i - 1], bus->stops[i]);
+    // участки i-1 -> i, последний элемент - замыкающий участок от последней остановки к первой
+    geo::PreparedCoordinatesArray segment_from;
+    geo::PreparedCoordinatesArray segment_to;
+    segment_from.Reserve(stops.size());
+    segment_to.Reserve(stops.size());
+    for (size_t i = 1; i < stops.size(); ++i) {
+        segment_from.PushBack(prepared_coords_[stops[i - 1]->id]);
+        segment_to.PushBack(prepared_coords_[stops[i]->id]);
+    }
+    segment_from.PushBack(prepared_coords_[stops.back()->id]);
+    segment_to.PushBack(prepared_coords_[stops.front()->id]);
+
+    std::vector<double> segment_geo(stops.size());
+    geo::ComputeDistances(segment_from, segment_to, segment_geo.data());
+
+    unsigned int road_length = 0;
+    double geo_length = 0;
+    for (size_t i = 0; i < stops.size(); ++i) {
+        if (i > 0) {
+            road_length += GetStopsDistance(stops[i - 1], stops[i]);
+            geo_length += segment_geo[i - 1];
+        }
+        lengths.road[i] = road_length;
+        lengths.geo[i] = geo_length;
     }
-    rout_length += GetStopsDistance(bus->stops.back(),bus->stops.front());
+    road_length += GetStopsDistance(stops.back(), stops.front());
+    geo_length += segment_geo.back();
 
-    return rout_length;
+    lengths.info = {static_cast<unsigned int>(stops.size()),
+                    CountUniqueStops(bus),
+                    road_length,
+                    road_length / geo_length};
+    return lengths;
 } 
 
 }
\ No newline at end of file
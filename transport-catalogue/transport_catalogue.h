@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <string>
 #include <string_view>
@@ -11,7 +15,10 @@
 #include <optional>
 
 
+#include "arena.h"
 #include "domain.h"
+#include "perfect_hash.h"
+#include "string_interner.h"
 
 namespace catalogue {
 
@@ -28,25 +35,147 @@ class TransportCatalogue {
 
 public:
 
+	// Индексы имён. Узлы таблиц и множеств лежат в арене справочника
+	template <typename Value>
+	using NameIndex = std::unordered_map<std::string_view, Value, std::hash<std::string_view>, std::equal_to<std::string_view>,
+										 ArenaAllocator<std::pair<const std::string_view, Value>>>;
+	using BusNames = std::set<std::string_view, std::less<std::string_view>, ArenaAllocator<std::string_view>>;
+	using StopIndex = NameIndex<const Stop*>;
+	using BusIndex = NameIndex<const Bus*>;
+	using BusesOnStops = NameIndex<BusNames>;
+
+	// Записи пакетной загрузки. Строки должны жить до Freeze()
+	struct StopRecord {
+		std::string_view name;
+		geo::Coordinates coord;
+	};
+	// Расстояния до неизвестных остановок пропускаются
+	struct DistanceRecord {
+		std::string_view from;
+		std::string_view to;
+		unsigned int dist;
+	};
+	// Неизвестная остановка маршрута - std::out_of_range из Freeze(); накопленные записи
+	// тогда отбрасываются, а справочник не меняется
+	struct BusRecord {
+		std::string_view name;
+		std::vector<std::string_view> stops;
+		bool is_roundtrip = false;
+	};
+	struct BulkData {
+		std::vector<StopRecord> stops;
+		std::vector<DistanceRecord> distances;
+		std::vector<BusRecord> buses;
+	};
+
+	// Изменения замороженного справочника для ApplyDelta(). Для REMOVE значимы только имена
+	// (у расстояния - from и to); расстояния из StopRecord не берутся, они передаются отдельно
+	enum class DeltaAction {
+		ADD,
+		REPLACE,
+		REMOVE,
+	};
+	template <typename Record>
+	struct DeltaRecord {
+		DeltaAction action;
+		Record record;
+	};
+	struct DeltaData {
+		std::vector<DeltaRecord<StopRecord>> stops;
+		std::vector<DeltaRecord<DistanceRecord>> distances;
+		std::vector<DeltaRecord<BusRecord>> buses;
+	};
+
 	void AddStop(std::string_view name, geo::Coordinates coord);
 	void AddStopsDistance(const Stop* from_stop, const Stop* to_stop, unsigned int dist);
 	void AddBus(Bus bus);
 
+	// Пакетная загрузка. Записи только накапливаются, их можно передавать целиком
+	// или частями по ходу потокового разбора; справочник меняется в Freeze()
+	void Load(BulkData data);
+	// Добавляет накопленные записи так, как если бы сначала были добавлены все остановки,
+	// затем расстояния и маршруты, но строит индексы разом и параллельно. После этого
+	// справочник только для чтения: Add*, Load и Freeze выбрасывают std::logic_error,
+	// а имена ищутся по совершенному хешу вместо хеш-таблиц
+	void Freeze();
+	bool IsFrozen() const{
+		return frozen_;
+	}
+	// Меняет замороженный справочник за время, пропорциональное изменению: пересчитываются
+	// только списки смежности затронутых остановок, их множества маршрутов и статистика
+	// маршрутов, проходящих через изменённые остановки и участки.
+	// Как и в base_requests, порядок записей разных видов не важен: сначала удаляются маршруты,
+	// затем добавляются и заменяются остановки, задаются расстояния (ADD и REPLACE равнозначны),
+	// добавляются и заменяются маршруты и в конце удаляются остановки.
+	// ADD существующего имени, удаление остановки, через которую идут маршруты, или отсутствующего
+	// расстояния - std::invalid_argument; неизвестное имя - std::out_of_range. Записи, применённые
+	// до ошибки, остаются в силе, статистика затронутых ими маршрутов пересчитывается.
+	// Удалённые остановки и маршруты сохраняют свои id. Когда освобождённой изменениями памяти
+	// в арене становится больше, чем занятой, справочник переносится в новую арену, как Clone():
+	// указатели на остановки и маршруты, полученные до вызова, тогда недействительны
+	void ApplyDelta(const DeltaData& delta);
+
+	// Независимая копия: изменения одной не видны другой. Уже сохранённые строки имён
+	// копии делят, всё остальное копируется, указатели переводятся на свои записи
+	TransportCatalogue Clone() const;
+
 	BusRoutInfo GetRouteInfo(std::string_view name) const;
 	std::set<std::string_view> GetStopInfo(std::string_view stop_name) const;
 	
-	const std::unordered_map<std::string_view, const Bus*>& GetAllBuses() const{
+	const BusIndex& GetAllBuses() const{
 		return bus_ptrs_;
 	}
-	const std::unordered_map<std::string_view, const Stop*>& GetAllStops() const{
+	const StopIndex& GetAllStops() const{
 		return stop_ptrs_;
 	}
-	const std::unordered_map<std::string_view, std::set<std::string_view>>& GetAllBusesOnStops() const{
+	const BusesOnStops& GetAllBusesOnStops() const{
 		return buses_on_stop_;
 	}
-	unsigned int GetStopsDistance(const Stop* from_stop, const Stop* to_stop) const;
+	// Расстояние по дорогам; если задано только обратное направление, используется оно
+	unsigned int GetStopsDistance(const Stop* from_stop, const Stop* to_stop) const{
+		if(from_stop->id >= road_distances_.size()){
+			return 0;
+		}
+		const auto& adjacent = road_distances_[from_stop->id];
+		const auto it = FindAdjacent(adjacent, to_stop->id);
+		if(it != adjacent.end() && it->to == to_stop->id){
+			return it->dist;
+		}
+		return 0;
+	}
 	
+	// Длина участка маршрута по дорогам между остановками с индексами from_index <= to_index
+	unsigned int GetRoadDistanceOnRoute(const Bus* bus, size_t from_index, size_t to_index) const{
+		const auto& road = bus_lengths_.at(bus->id).road;
+		return road[to_index] - road[from_index];
+	}
+	double GetGeographicalDistanceOnRoute(const Bus* bus, size_t from_index, size_t to_index) const{
+		const auto& geo = bus_lengths_.at(bus->id).geo;
+		return geo[to_index] - geo[from_index];
+	}
+
+	// Все имена остановок и маршрутов справочника, по одной копии каждого
+	const StringInterner& GetNames() const{
+		return names_;
+	}
+	// Память, которую остановки, маршруты и индексы взяли из арены справочника.
+	// Освобождённое учитывается в freed_bytes и возвращается, когда ApplyDelta() переносит справочник в новую арену
+	ArenaStats GetArenaStats() const{
+		return arena_ != nullptr ? arena_->GetStats() : ArenaStats{};
+	}
+
+	friend void WriteSnapshot(const TransportCatalogue& catalogue, std::ostream& output);
+	friend TransportCatalogue LoadSnapshot(const std::string& path);
+
 	std::optional<const Stop*> GetStopByName(std::string_view name) const{
+		if(frozen_){
+			if(const StopSlot* slot = FindStopSlot(name)){
+				return slot->stop;
+			}
+			if(!name_index_partial_){
+				return std::nullopt;
+			}
+		}
 		if(const auto it = stop_ptrs_.find(name); it != stop_ptrs_.end()){
 			return it->second;
 		}
@@ -54,28 +183,135 @@ public:
 	}
 	
 private:
-	std::deque<Stop> stops_;
-	std::deque<Bus> buses_;
-	std::unordered_map<std::string_view, const Stop*> stop_ptrs_;
-	std::unordered_map<std::string_view, const Bus*> bus_ptrs_;
-	std::unordered_map<std::string_view, std::set<std::string_view>> buses_on_stop_;
-
-	struct StopPairHash {
-		size_t operator()(const std::pair<const Stop*, const Stop*>& p) const noexcept {
-			size_t hash_value = 0;
-			std::hash<const void*> hash_ptr;
-			hash_value ^= hash_ptr(p.first);
-			hash_value ^= hash_ptr(p.second);
-			return hash_value;
+	// Живёт, пока жив хотя бы один контейнер с её аллокатором, поэтому перемещение
+	// справочника не меняет адресов. Без арены (у перемещённого справочника) память берётся из кучи
+	std::shared_ptr<Arena> arena_ = std::make_shared<Arena>();
+
+	template <typename T>
+	ArenaAllocator<T> GetAllocator() const{
+		return ArenaAllocator<T>(arena_);
+	}
+
+	StringInterner names_;
+	std::deque<Stop, ArenaAllocator<Stop>> stops_{GetAllocator<Stop>()};
+	std::deque<Bus, ArenaAllocator<Bus>> buses_{GetAllocator<Bus>()};
+	StopIndex stop_ptrs_{GetAllocator<StopIndex::value_type>()};
+	BusIndex bus_ptrs_{GetAllocator<BusIndex::value_type>()};
+	BusesOnStops buses_on_stop_{GetAllocator<BusesOnStops::value_type>()};
+
+	// Ребро списка смежности: остановка назначения и расстояние до неё.
+	// is_direct == false означает, что значение взято из обратного направления
+	struct RoadDistance {
+		uint32_t to;
+		unsigned int dist;
+		bool is_direct;
+	};
+	using AdjacentStops = std::vector<RoadDistance, ArenaAllocator<RoadDistance>>;
+
+	// Подготовленные для расчёта расстояний координаты, индекс - Stop::id
+	geo::PreparedCoordinatesArray prepared_coords_;
+
+	// Отсортированные по to списки смежности, индекс - Stop::id. Сами списки лежат в арене
+	std::vector<AdjacentStops> road_distances_;
+
+	static AdjacentStops::const_iterator FindAdjacent(const AdjacentStops& adjacent, uint32_t to){
+		// у большинства остановок несколько соседей, линейный проход дешевле бинарного поиска
+		if(adjacent.size() <= 8){
+			auto it = adjacent.begin();
+			while(it != adjacent.end() && it->to < to){
+				++it;
+			}
+			return it;
 		}
+		return std::lower_bound(adjacent.begin(), adjacent.end(), to,
+								[](const RoadDistance& lhs, uint32_t rhs){ return lhs.to < rhs; });
+	}
+	static void SetAdjacent(AdjacentStops& adjacent, uint32_t to, unsigned int dist, bool is_direct);
+
+	// Префиксные суммы длин участков маршрута: road[i] - путь от первой остановки до i-й.
+	// Считаются один раз в AddBus, поэтому расстояния нужно добавлять до маршрутов.
+	// Хранятся для всего пути, у некольцевого маршрута это 2n-1 точек: расстояния по дорогам
+	// в две стороны могут различаться, так что обратный путь отражением не получить
+	using RoadLengths = std::vector<unsigned int, ArenaAllocator<unsigned int>>;
+	using GeoLengths = std::vector<double, ArenaAllocator<double>>;
+	struct BusRouteLengths {
+		RoadLengths road;
+		GeoLengths geo;
+		BusRoutInfo info;
 	};
+	// Меньше стольких освобождённых байт арена не сжимается: копия мелкого справочника не окупается
+	static constexpr size_t MIN_ARENA_WASTE_TO_COMPACT = 1024 * 1024;
+
+	// Суммы для point_count точек пути в арене справочника
+	BusRouteLengths MakeRouteLengths(size_t point_count) const;
+
+	// Индекс - Bus::id
+	std::vector<BusRouteLengths> bus_lengths_;
 
-	std::unordered_map<std::pair<const Stop*, const Stop*>, unsigned int, StopPairHash> dist_between_stops_;
+	BulkData bulk_;
+	bool frozen_ = false;
+
+	// Индексы имён замороженного справочника: номер записи - совершенный хеш имени.
+	// Имя лежит в самой записи, так что проверка ключа - одно сравнение строк
+	struct StopSlot {
+		std::string_view name;
+		const Stop* stop = nullptr;
+		const BusNames* buses = nullptr;
+	};
+	struct BusSlot {
+		std::string_view name;
+		const Bus* bus = nullptr;
+	};
+	// После ApplyDelta() с новыми или удалёнными именами совершенный хеш покрывает не все имена:
+	// не найденное по нему ищется в хеш-таблицах
+	bool name_index_partial_ = false;
+	PerfectHash stop_hash_;
+	std::vector<StopSlot> stop_slots_;
+	PerfectHash bus_hash_;
+	std::vector<BusSlot> bus_slots_;
+
+	const StopSlot* FindStopSlot(std::string_view name) const{
+		if(stop_slots_.empty()){
+			return nullptr;
+		}
+		const StopSlot& slot = stop_slots_[stop_hash_(name)];
+		return slot.stop != nullptr && slot.name == name ? &slot : nullptr;
+	}
+	const BusSlot* FindBusSlot(std::string_view name) const{
+		if(bus_slots_.empty()){
+			return nullptr;
+		}
+		const BusSlot& slot = bus_slots_[bus_hash_(name)];
+		return slot.bus != nullptr && slot.name == name ? &slot : nullptr;
+	}
+
+	void CheckNotFrozen() const;
+	// Неизвестная остановка маршрута - std::out_of_range
+	void CheckBusStops(const BulkData& data) const;
+	void FreezeStops(const std::vector<StopRecord>& stops);
+	void FreezeDistances(const std::vector<DistanceRecord>& distances);
+	void FreezeBuses(const std::vector<BusRecord>& buses);
+	void FreezeBusesOnStops(size_t first_bus);
+	void FreezeStopIndex();
+	void FreezeBusIndex();
+
+	// Шаги ApplyDelta(); в dirty_buses попадают id маршрутов, статистику которых нужно пересчитать
+	const Stop* FindLiveStop(std::string_view name) const;
+	Bus* FindLiveBus(std::string_view name);
+	void MarkBusesThrough(const Stop* stop, std::vector<uint32_t>& dirty_buses) const;
+	void MarkBusesBetween(const Stop* from, const Stop* to, std::vector<uint32_t>& dirty_buses) const;
+	void DeltaAddStop(const StopRecord& record);
+	void DeltaReplaceStop(const StopRecord& record, std::vector<uint32_t>& dirty_buses);
+	void DeltaRemoveStop(std::string_view name);
+	void DeltaSetDistance(const DistanceRecord& record, std::vector<uint32_t>& dirty_buses);
+	void DeltaRemoveDistance(const DistanceRecord& record, std::vector<uint32_t>& dirty_buses);
+	StopSequence ResolveRoute(const BusRecord& record) const;
+	void DeltaAddBus(const BusRecord& record, std::vector<uint32_t>& dirty_buses);
+	void DeltaReplaceBus(const BusRecord& record, std::vector<uint32_t>& dirty_buses);
+	void DeltaRemoveBus(std::string_view name);
 
 	unsigned int CountUniqueStops(const Bus* bus) const;
-	
-	double ComputeGeographicalRouteLength(const Bus* bus) const;
-	unsigned int ComputeRoadRouteLength(const Bus* bus) const;
+	BusRouteLengths ComputeRouteLengths(const Bus* bus) const;
 
 };
 
@@ -3,7 +3,8 @@
 namespace routing {
 
 TransportRouter::TransportRouter(const catalogue::TransportCatalogue& catalog, Settings settings)
-    :settings_(std::move(settings)){
+    :settings_(std::move(settings))
+    ,names_(&catalog.GetNames()){
         graph_ = std::move(GenerateGraph(catalog));
         router_.emplace(graph_);
 }
@@ -13,7 +14,7 @@ std::optional<RouteData> TransportRouter::BuildRoute(std::string_view from_stop,
         return std::nullopt;
     }
     std::optional<graph::Router<Weight>::RouteInfo> route = 
-                    router_.value().BuildRoute(stop_to_vertex_.at(std::string(from_stop))[0],stop_to_vertex_.at(std::string(to_stop))[0]);
+                    router_.value().BuildRoute(stop_to_vertex_.at(from_stop),stop_to_vertex_.at(to_stop));
     if(route.has_value()){
         const auto& route_info = *route;
         
@@ -22,7 +23,14 @@ std::optional<RouteData> TransportRouter::BuildRoute(std::string_view from_stop,
         result.total_time = route_info.weight;
 
         for(const auto& edge_id : route_info.edges){
-            result.parts.push_back(dist_between_stops_.at(edge_id));
+            const EdgeInfo& info = edges_[edge_id];
+            const Weight time = graph_.GetEdge(edge_id).weight;
+            const std::string_view name = names_->GetString(info.name);
+            if(info.span_count == 0){
+                result.parts.push_back(WaitEdge("Wait", time, name));
+            }else{
+                result.parts.push_back(BusEdge("Bus", time, name, info.span_count));
+            }
         }
         return result;
     }
@@ -33,8 +41,8 @@ std::optional<RouteData> TransportRouter::BuildRoute(std::string_view from_stop,
 graph::DirectedWeightedGraph<Weight> TransportRouter::GenerateGraph(const catalogue::TransportCatalogue& catalog){
     graph::DirectedWeightedGraph<Weight> graph(catalog.GetAllStops().size() * 2);
 
-    const auto stops = catalog.GetAllStops();
-    const auto buses = catalog.GetAllBuses();
+    const auto& stops = catalog.GetAllStops();
+    const auto& buses = catalog.GetAllBuses();
     
     size_t numb_vertex = 0;
     
@@ -50,35 +58,38 @@ graph::DirectedWeightedGraph<Weight> TransportRouter::GenerateGraph(const catalo
     return graph;
 }
 
-void TransportRouter::AddStopWaitEdge(graph::DirectedWeightedGraph<Weight>& graph, const std::string& stop, size_t& numb_vertex){
+void TransportRouter::AddStopWaitEdge(graph::DirectedWeightedGraph<Weight>& graph, std::string_view stop, size_t& numb_vertex){
     graph::Edge<Weight> edge = {.from = numb_vertex,
                                 .to = ++numb_vertex,
                                 .weight = settings_.bus_wait_time};
         
-    stop_to_vertex_.emplace(stop, std::vector<graph::EdgeId>{edge.from, edge.to});
+    stop_to_vertex_.emplace(stop, edge.from);
 
-    const auto added_edge = graph.AddEdge(edge);
-    dist_between_stops_[added_edge] = WaitEdge("Wait", settings_.bus_wait_time, stop);
+    graph.AddEdge(edge);
+    edges_.push_back({names_->Find(stop).value(), 0});
 
 }
 
 void TransportRouter::AddBusEdges(graph::DirectedWeightedGraph<Weight>& graph, const catalogue::TransportCatalogue& catalog, const catalogue::Bus& bus){
-    const std::vector<const catalogue::Stop*>& stops_on_bus = bus.stops;
+    const catalogue::RouteStops stops_on_bus = bus.GetRoute();
+    const catalogue::Symbol bus_name = names_->Find(bus.name).value();
+    // Вершины остановок ищутся по имени один раз на остановку, а не на каждую пару
+    std::vector<graph::VertexId> vertices;
+    vertices.reserve(stops_on_bus.size());
+    for(const catalogue::Stop* stop : stops_on_bus){
+        vertices.push_back(stop_to_vertex_.at(stop->name));
+    }
     for(size_t i = 0; i < stops_on_bus.size(); ++i){
-        const auto& from_stop = stops_on_bus.at(i);
-        unsigned int dist = 0;
-
         for(size_t j = i + 1; j < stops_on_bus.size(); ++j){
-            const auto& to_stop = stops_on_bus.at(j);
-            dist += catalog.GetStopsDistance(stops_on_bus.at(j-1), to_stop);
-            Weight time_on_dist = static_cast<Weight>(dist)/settings_.GetVelosityMetersPerMinut();
+            const unsigned int dist = catalog.GetRoadDistanceOnRoute(&bus, i, j);
+            Weight time_on_dist = static_cast<Weight>(dist)/settings_.GetVelocityMetersPerMinut();
 
-            graph::Edge<Weight> edge = {.from = stop_to_vertex_.at(from_stop->name)[1],
-                                        .to = stop_to_vertex_.at(to_stop->name)[0],
+            graph::Edge<Weight> edge = {.from = vertices[i] + 1,
+                                        .to = vertices[j],
                                         .weight = time_on_dist};
-            const auto added_edge = graph.AddEdge(edge);
-            size_t span_count = j - i;
-            dist_between_stops_[added_edge] = BusEdge("Bus", time_on_dist, bus.name, span_count);
+            graph.AddEdge(edge);
+            const auto span_count = static_cast<uint32_t>(j - i);
+            edges_.push_back({bus_name, span_count});
         }
     }
 }
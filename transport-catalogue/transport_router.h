@@ -23,22 +23,23 @@ struct Settings{
     }
 };
 
+// Имена ссылаются на строки справочника и действительны, пока он жив
 struct RouteEdge {
-    std::string type;
+    std::string_view type;
     Weight time;
-    std::string name;
+    std::string_view name;
 };
 struct WaitEdge : public RouteEdge{
     WaitEdge() = default;
     WaitEdge(std::string_view t, Weight w, std::string_view n)
-        : RouteEdge{std::string(t), w, std::string(n)} {}
+        : RouteEdge{t, w, n} {}
 };
 
 struct BusEdge : public RouteEdge {
     BusEdge() = default;
     size_t span_count;
     BusEdge(std::string_view t, Weight w, std::string_view n, size_t span)
-        : RouteEdge{std::string(t), w, std::string(n)}, span_count(span) {}
+        : RouteEdge{t, w, n}, span_count(span) {}
 };
 
 using RoutEdgeVariants = std::variant<WaitEdge, BusEdge>;
@@ -49,6 +50,7 @@ struct RouteData {
 };
 
 
+// Справочник должен жить, пока жив маршрутизатор: имена остановок и маршрутов не копируются
 class TransportRouter{
 public:
     TransportRouter(const catalogue::TransportCatalogue& catalog, Settings settings);
@@ -60,13 +62,22 @@ private:
     graph::DirectedWeightedGraph<Weight> graph_;
     std::optional<graph::Router<Weight>> router_;
 
-    std::unordered_map<std::string, std::vector<graph::EdgeId>> stop_to_vertex_;
-    std::unordered_map<graph::EdgeId, RoutEdgeVariants> dist_between_stops_;
+    // Что означает ребро графа, индекс - EdgeId. Имя хранится символом
+    // и превращается в строку, только когда ребро попадает в ответ
+    struct EdgeInfo {
+        catalogue::Symbol name;
+        uint32_t span_count;    // 0 - ожидание на остановке
+    };
+
+    const catalogue::StringInterner* names_ = nullptr;
+    // Вершина начала ожидания на остановке; следующая за ней - конец ожидания
+    std::unordered_map<std::string_view, graph::VertexId> stop_to_vertex_;
+    std::vector<EdgeInfo> edges_;
 
 
     graph::DirectedWeightedGraph<Weight> GenerateGraph(const catalogue::TransportCatalogue& catalog);
 
-    void AddStopWaitEdge(graph::DirectedWeightedGraph<Weight>& graph, const std::string& stop, size_t& numb_vertex);
+    void AddStopWaitEdge(graph::DirectedWeightedGraph<Weight>& graph, std::string_view stop, size_t& numb_vertex);
     void AddBusEdges(graph::DirectedWeightedGraph<Weight>& graph, 
                     const catalogue::TransportCatalogue& catalog, const catalogue::Bus& bus);
 
@@ -0,0 +1,107 @@
+#include "versioned_catalogue.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace catalogue {
+
+namespace {
+
+void CheckFrozen(const TransportCatalogue& catalogue) {
+    if (!catalogue.IsFrozen()) {
+        throw std::logic_error("Only a frozen catalogue can be published");
+    }
+}
+
+}  // namespace
+
+VersionedCatalogue::ReadGuard::ReadGuard(std::atomic<uint64_t>& slot, const Version* version)
+    : slot_(&slot)
+    , version_(version) {
+}
+
+VersionedCatalogue::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+    : slot_(std::exchange(other.slot_, nullptr))
+    , version_(std::exchange(other.version_, nullptr)) {
+}
+
+VersionedCatalogue::ReadGuard::~ReadGuard() {
+    if (slot_ != nullptr) {
+        slot_->store(IDLE);
+    }
+}
+
+const TransportCatalogue& VersionedCatalogue::ReadGuard::operator*() const {
+    return version_->catalogue;
+}
+
+const TransportCatalogue* VersionedCatalogue::ReadGuard::operator->() const {
+    return &version_->catalogue;
+}
+
+uint64_t VersionedCatalogue::ReadGuard::GetVersion() const {
+    return version_->number;
+}
+
+VersionedCatalogue::VersionedCatalogue(TransportCatalogue initial, size_t max_readers)
+    : slots_(std::make_unique<ReaderSlot[]>(std::max<size_t>(max_readers, 1)))
+    , slot_count_(std::max<size_t>(max_readers, 1)) {
+    CheckFrozen(initial);
+    current_.store(new Version{std::move(initial), 1});
+}
+
+VersionedCatalogue::~VersionedCatalogue() {
+    delete current_.load();
+}
+
+// Все операции с эпохой и указателем версии - seq_cst. Если читатель прочитал заменённую
+// версию, то его объявление эпохи предшествует замене, а прочитанная им эпоха не больше
+// эпохи замены, поэтому ReclaimLocked() увидит её в слоте и версию не удалит
+VersionedCatalogue::ReadGuard VersionedCatalogue::Read() const {
+    // Потоки начинают поиск свободного слота с разных мест
+    const size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    for (size_t i = 0; i < slot_count_; ++i) {
+        std::atomic<uint64_t>& slot = slots_[(start + i) % slot_count_].epoch;
+        uint64_t expected = IDLE;
+        if (slot.load(std::memory_order_relaxed) == IDLE && slot.compare_exchange_strong(expected, epoch_.load())) {
+            return ReadGuard(slot, current_.load());
+        }
+    }
+    throw std::length_error("Too many concurrent catalogue readers");
+}
+
+uint64_t VersionedCatalogue::Publish(TransportCatalogue next) {
+    std::lock_guard guard(write_mutex_);
+    return PublishLocked(std::move(next));
+}
+
+size_t VersionedCatalogue::Reclaim() {
+    std::lock_guard guard(write_mutex_);
+    return ReclaimLocked();
+}
+
+uint64_t VersionedCatalogue::PublishLocked(TransportCatalogue next) {
+    CheckFrozen(next);
+    const uint64_t number = current_.load()->number + 1;
+    retired_.reserve(retired_.size() + 1);
+    Version* previous = current_.exchange(new Version{std::move(next), number});
+    retired_.push_back({std::unique_ptr<Version>(previous), epoch_.fetch_add(1)});
+    ReclaimLocked();
+    return number;
+}
+
+size_t VersionedCatalogue::ReclaimLocked() {
+    uint64_t min_epoch = IDLE;
+    for (size_t i = 0; i < slot_count_; ++i) {
+        min_epoch = std::min(min_epoch, slots_[i].epoch.load());
+    }
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(), [min_epoch](const RetiredVersion& retired) {
+        return retired.epoch < min_epoch;
+    }), retired_.end());
+    return retired_.size();
+}
+
+}  // namespace catalogue
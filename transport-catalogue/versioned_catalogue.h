@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "transport_catalogue.h"
+
+namespace catalogue {
+
+/*
+ * Версии справочника для одновременной работы читателей и писателя (MVCC).
+ * Опубликованная версия больше не меняется. Читатель объявляет текущую эпоху в своём слоте
+ * и читает версию без блокировок; писатель меняет копию текущей версии и публикует её
+ * атомарной заменой указателя. Заменённая версия удаляется, когда не остаётся читателей,
+ * объявивших эпоху не позже её замены (epoch-based reclamation).
+ *
+ *     VersionedCatalogue versions(std::move(catalogue));
+ *     // поток читателя
+ *     const auto version = versions.Read();
+ *     version->GetRouteInfo("297");
+ *     // поток писателя
+ *     versions.Update([&delta](TransportCatalogue& next){ next.ApplyDelta(delta); });
+ */
+class VersionedCatalogue {
+    struct Version;
+
+public:
+    // Закреплённая версия. Указатели и ссылки, полученные из неё, действительны,
+    // пока жив этот объект
+    class ReadGuard {
+    public:
+        ReadGuard(ReadGuard&& other) noexcept;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard();
+
+        const TransportCatalogue& operator*() const;
+        const TransportCatalogue* operator->() const;
+        // Номер версии: 1 у исходного справочника, далее +1 на каждую публикацию
+        uint64_t GetVersion() const;
+
+    private:
+        friend class VersionedCatalogue;
+        ReadGuard(std::atomic<uint64_t>& slot, const Version* version);
+
+        std::atomic<uint64_t>* slot_;
+        const Version* version_;
+    };
+
+    static constexpr size_t DEFAULT_MAX_READERS = 128;
+
+    // Справочник должен быть заморожен, иначе std::logic_error
+    explicit VersionedCatalogue(TransportCatalogue initial, size_t max_readers = DEFAULT_MAX_READERS);
+    VersionedCatalogue(const VersionedCatalogue&) = delete;
+    VersionedCatalogue& operator=(const VersionedCatalogue&) = delete;
+    // К этому моменту все ReadGuard должны быть разрушены
+    ~VersionedCatalogue();
+
+    // Без блокировок и ожидания писателя. Одновременно закреплённых версий может быть
+    // не больше max_readers, иначе std::length_error
+    ReadGuard Read() const;
+
+    // Писатели выполняются по одному. func(TransportCatalogue&) меняет копию текущей версии,
+    // например через ApplyDelta(); если func выбросил исключение, ничего не публикуется.
+    // Возвращает номер опубликованной версии
+    template <typename Func>
+    uint64_t Update(Func func) {
+        std::lock_guard guard(write_mutex_);
+        TransportCatalogue next = current_.load()->catalogue.Clone();
+        func(next);
+        return PublishLocked(std::move(next));
+    }
+    // Публикует готовый замороженный справочник как следующую версию
+    uint64_t Publish(TransportCatalogue next);
+
+    // Удаляет заменённые версии, которые больше никто не читает (это делает и каждая
+    // публикация); возвращает число версий, которые ещё ждут удаления
+    size_t Reclaim();
+
+private:
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    struct Version {
+        TransportCatalogue catalogue;
+        uint64_t number;
+    };
+    // Эпоха, объявленная читателем, или IDLE. Слоты на разных кеш-линиях,
+    // чтобы читатели разных потоков не мешали друг другу
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{IDLE};
+    };
+    // Версия, заменённая в эпоху epoch: её могут читать только читатели с эпохой <= epoch
+    struct RetiredVersion {
+        std::unique_ptr<Version> version;
+        uint64_t epoch;
+    };
+
+    std::atomic<Version*> current_;
+    std::atomic<uint64_t> epoch_{0};
+    std::unique_ptr<ReaderSlot[]> slots_;
+    size_t slot_count_;
+
+    std::mutex write_mutex_;
+    std::vector<RetiredVersion> retired_;
+
+    uint64_t PublishLocked(TransportCatalogue next);
+    size_t ReclaimLocked();
+};
+
+}  // namespace catalogue